@@ -0,0 +1,145 @@
+/**
+ * @file labelm_batch.h
+ * @brief Production batches and a queue of pending work orders
+ *
+ * A batch labels a fixed quantity of products under a batch id. The
+ * BatchScheduler holds the active batch and the orders waiting behind it;
+ * LabelingMachine counts each applied label into the active batch and,
+ * when the quantity is reached, completes it and starts the next order
+ * without stopping the line.
+ *
+ * Changeovers: an order may name the roll to load for it. If the labels
+ * left on the current roll at the end of a batch will not cover the next
+ * order, the roll change is staged STAGE_LEAD_LABELS before the batch
+ * ends (ROLL_CHANGE_STAGED tells the operator to have that roll ready)
+ * and the roll is loaded at the batch boundary, instead of the line
+ * running the roll empty in the middle of the next batch.
+ */
+#ifndef LABELM_BATCH_H
+#define LABELM_BATCH_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+/**
+ * @struct WorkOrder
+ * @brief One batch waiting to be produced
+ */
+struct WorkOrder {
+    std::string batchId;
+    int quantity = 0;                   ///< Products to label
+    int rollLabels = 0;                 ///< Roll loaded at the changeover if the current one cannot finish the order (0: none)
+};
+
+/**
+ * @enum BatchStatus
+ * @brief State of the most recent batch
+ */
+enum class BatchStatus {
+    NONE,           ///< No batch has been started
+    ACTIVE,         ///< Labels are counted into this batch
+    COMPLETED,      ///< Quantity reached
+    CANCELLED       ///< Cancelled before the quantity was reached
+};
+
+/**
+ * @struct BatchProgress
+ * @brief Progress of the active (or most recent) batch
+ */
+struct BatchProgress {
+    std::string batchId;
+    int quantity = 0;
+    int labeled = 0;                    ///< Labels applied in this batch
+    BatchStatus status = BatchStatus::NONE;
+
+    int remaining() const { return quantity - labeled; }
+};
+
+/**
+ * @enum BatchStep
+ * @brief What the machine has to do after a label was counted
+ */
+enum class BatchStep {
+    NONE,
+    STAGE_ROLL,     ///< Lead point reached: stage the roll of the next order
+    COMPLETE        ///< Quantity reached: complete the batch and advance
+};
+
+/**
+ * @class BatchScheduler
+ * @brief Active batch and the FIFO of pending work orders
+ *
+ * Counting a label and reading progress are O(1). Not thread-safe; used
+ * from the machine's control thread.
+ */
+class BatchScheduler {
+public:
+    /// Labels before the end of a batch at which the next roll change is staged
+    static constexpr int STAGE_LEAD_LABELS = 50;
+
+    /**
+     * @brief Appends an order to the queue
+     */
+    void enqueue(const WorkOrder& order) { pendingOrders.push_back(order); }
+
+    /**
+     * @brief Removes a pending order
+     * @return false if no pending order has this id
+     */
+    bool remove(const std::string& batchId);
+
+    /**
+     * @brief Makes an order the active batch
+     */
+    void begin(const WorkOrder& order);
+
+    /**
+     * @brief Takes the next pending order
+     * @return false if the queue is empty
+     */
+    bool popNext(WorkOrder& order);
+
+    /**
+     * @brief Counts one applied label into the active batch
+     * @param rollRemaining Labels left on the roll after this label
+     */
+    BatchStep onLabel(int rollRemaining) {
+        if (progress.status != BatchStatus::ACTIVE) {
+            return BatchStep::NONE;
+        }
+        progress.labeled++;
+        if (progress.labeled >= progress.quantity) {
+            progress.status = BatchStatus::COMPLETED;
+            return BatchStep::COMPLETE;
+        }
+        if (progress.labeled == stageAt && !rollStaged) {
+            return planChangeover(rollRemaining);
+        }
+        return BatchStep::NONE;
+    }
+
+    /**
+     * @brief Ends the active batch early
+     * @return false if no batch is active
+     */
+    bool cancel();
+
+    const BatchProgress& current() const { return progress; }
+    bool isActive() const { return progress.status == BatchStatus::ACTIVE; }
+    std::size_t pending() const { return pendingOrders.size(); }
+    const WorkOrder* next() const { return pendingOrders.empty() ? nullptr : &pendingOrders.front(); }
+
+private:
+    /**
+     * @brief Decides at the lead point whether the next order needs a new roll
+     */
+    BatchStep planChangeover(int rollRemaining);
+
+    BatchProgress progress;
+    std::deque<WorkOrder> pendingOrders;
+    int stageAt = 0;                    ///< Batch label count at which the changeover is planned
+    bool rollStaged = false;            ///< Changeover already planned for this batch
+};
+
+#endif // LABELM_BATCH_H
@@ -0,0 +1,118 @@
+/**
+ * @file labelm_checkpoint.h
+ * @brief Crash-safe checkpoint of the machine's production counters
+ *
+ * The checkpoint file is a 64-byte header followed by two 64-byte slots,
+ * mapped shared into the machine. Each save() writes the slot not holding
+ * the newest checkpoint: the counters, a sequence number and a checksum
+ * over both, all plain stores into the mapping. The other slot still holds
+ * the previous checkpoint intact, so a crash in the middle of a save costs
+ * at most that one update.
+ *
+ * Like the mapped ring log, stores survive a crash of the controller
+ * process (the kernel owns the pages); sync() writes them to disk, which
+ * protects against power loss as well. Recovery reads two slots, so it
+ * takes the same time however long the machine has been running.
+ */
+#ifndef LABELM_CHECKPOINT_H
+#define LABELM_CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct CheckpointCounters
+ * @brief Counters persisted across restarts
+ */
+struct CheckpointCounters {
+    std::int32_t productsLabeled = 0;
+    std::int32_t errorCount = 0;
+    std::int32_t labelRollRemaining = 0;
+};
+
+/**
+ * @struct CheckpointSlot
+ * @brief One copy of the counters in the checkpoint file
+ */
+struct CheckpointSlot {
+    std::uint64_t sequence;             ///< Saves so far when this slot was written (0: never)
+    std::int32_t productsLabeled;
+    std::int32_t errorCount;
+    std::int32_t labelRollRemaining;
+    std::uint32_t checksum;             ///< checkpointChecksum() of the fields above
+    std::uint8_t reserved[40];          ///< Zero
+};
+
+static_assert(sizeof(CheckpointSlot) == 64, "checkpoint slots must stay 64 bytes");
+
+/**
+ * @struct CheckpointHeader
+ * @brief First 64 bytes of a checkpoint file
+ */
+struct CheckpointHeader {
+    char magic[4];                      ///< "LMC1"
+    std::uint16_t version;              ///< Format version (CHECKPOINT_VERSION)
+    std::uint16_t slotSize;             ///< sizeof(CheckpointSlot)
+    std::uint8_t reserved[56];          ///< Zero
+};
+
+static_assert(sizeof(CheckpointHeader) == 64, "checkpoint header must stay 64 bytes");
+
+constexpr char CHECKPOINT_MAGIC[4] = {'L', 'M', 'C', '1'};
+constexpr std::uint16_t CHECKPOINT_VERSION = 1;
+
+/**
+ * @brief Checksum of a slot's sequence and counters
+ */
+std::uint32_t checkpointChecksum(const CheckpointSlot& slot);
+
+/**
+ * @class CounterCheckpoint
+ * @brief Owns the mapping of one checkpoint file
+ *
+ * An existing valid file is reopened and its newest slot can be read with
+ * restore(); anything else (missing, wrong size or magic) is recreated
+ * empty.
+ */
+class CounterCheckpoint {
+public:
+    explicit CounterCheckpoint(const std::string& path);
+    ~CounterCheckpoint();
+
+    CounterCheckpoint(const CounterCheckpoint&) = delete;
+    CounterCheckpoint& operator=(const CounterCheckpoint&) = delete;
+
+    /**
+     * @brief true if the file is mapped
+     */
+    bool isOpen() const { return header != nullptr; }
+
+    /**
+     * @brief Reads the newest slot whose checksum is valid
+     * @return false if no slot is valid (new file or both slots damaged)
+     */
+    bool restore(CheckpointCounters& counters) const;
+
+    /**
+     * @brief Writes the counters into the older slot (no system calls, no clock read)
+     */
+    void save(const CheckpointCounters& counters);
+
+    /**
+     * @brief Writes the mapping back to disk and waits for it (msync MS_SYNC)
+     */
+    void sync();
+
+    /**
+     * @brief Saves since the file was created
+     */
+    std::uint64_t sequence() const { return lastSequence; }
+
+private:
+    CheckpointHeader* header = nullptr; ///< Start of the mapping
+    CheckpointSlot* slots = nullptr;    ///< The two slots following the header
+    std::uint64_t lastSequence = 0;     ///< Sequence of the newest valid slot
+};
+
+#endif // LABELM_CHECKPOINT_H
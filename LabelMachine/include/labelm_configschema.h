@@ -0,0 +1,130 @@
+/**
+ * @file labelm_configschema.h
+ * @brief Keys, types and valid ranges of the machine configuration file
+ *
+ * The configuration file holds `key=value` lines; `#` starts a comment
+ * line. CONFIG_SCHEMA lists every known key with the MachineConfig member
+ * it sets and its valid range. parseConfigText() walks the file text with
+ * string_views and std::from_chars: no per-line allocation and no
+ * exceptions, whatever the input.
+ */
+#ifndef LABELM_CONFIGSCHEMA_H
+#define LABELM_CONFIGSCHEMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string_view>
+
+#include "labelm_types.h"
+
+/**
+ * @enum ConfigValueType
+ * @brief Type of a configuration value
+ */
+enum class ConfigValueType : std::uint8_t {
+    INT,
+    DOUBLE
+};
+
+/**
+ * @struct ConfigField
+ * @brief One key of the configuration file
+ *
+ * Exactly one of intMember/doubleMember is set, matching type.
+ */
+struct ConfigField {
+    std::string_view key;               ///< Key as written in the file
+    ConfigValueType type;
+    double minValue;                    ///< Smallest valid value
+    double maxValue;                    ///< Largest valid value
+    int MachineConfig::* intMember;     ///< Member set by an INT key
+    double MachineConfig::* doubleMember; ///< Member set by a DOUBLE key
+};
+
+/// Every key of the configuration file
+constexpr ConfigField CONFIG_SCHEMA[] = {
+    // defaultSpeed has never been range-checked; start() uses it as is
+    {"defaultSpeed",       ConfigValueType::INT,    std::numeric_limits<int>::min(), std::numeric_limits<int>::max(),
+                           &MachineConfig::defaultSpeed, nullptr},
+    {"maxSpeed",           ConfigValueType::INT,    0, 500,     &MachineConfig::maxSpeed, nullptr},
+    {"minSpeed",           ConfigValueType::INT,    10, 200,    &MachineConfig::minSpeed, nullptr},
+    {"maintenanceSpeed",   ConfigValueType::INT,    5, 1000,    &MachineConfig::maintenanceSpeed, nullptr},
+    {"initialLabelCount",  ConfigValueType::INT,    0, 10000,   &MachineConfig::initialLabelCount, nullptr},
+    {"lowLabelThreshold",  ConfigValueType::INT,    0, 500,     &MachineConfig::lowLabelThreshold, nullptr},
+    {"nominalTemperature", ConfigValueType::DOUBLE, 0.0, 100.0, nullptr, &MachineConfig::nominalTemperature},
+    {"maxTemperature",     ConfigValueType::DOUBLE, 20.0, 150.0, nullptr, &MachineConfig::maxTemperature},
+    {"productPitch",       ConfigValueType::INT,    10, 5000,   &MachineConfig::productPitch, nullptr},
+    {"rollWarningLead",    ConfigValueType::INT,    0, 86400,   &MachineConfig::rollWarningLead, nullptr},
+    {"rampAcceleration",   ConfigValueType::INT,    1, 10000,   &MachineConfig::rampAcceleration, nullptr},
+    {"rampJerk",           ConfigValueType::INT,    1, 100000,  &MachineConfig::rampJerk, nullptr},
+};
+
+/**
+ * @brief Looks up a key in CONFIG_SCHEMA
+ * @return The field, or null for an unknown key
+ */
+constexpr const ConfigField* findConfigField(std::string_view key) {
+    for (const ConfigField& field : CONFIG_SCHEMA) {
+        if (field.key == key) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+static_assert(findConfigField("maxSpeed") != nullptr && findConfigField("maxspeed") == nullptr,
+              "CONFIG_SCHEMA lookup is exact");
+
+/**
+ * @brief Current value of a field in config, as a double
+ */
+inline double configFieldValue(const ConfigField& field, const MachineConfig& config) {
+    return field.type == ConfigValueType::INT ? static_cast<double>(config.*field.intMember)
+                                              : config.*field.doubleMember;
+}
+
+/**
+ * @enum ConfigIssue
+ * @brief Outcome of one configuration line
+ */
+enum class ConfigIssue : std::uint8_t {
+    NONE,           ///< Value applied
+    MALFORMED_LINE, ///< No `=` in the line
+    UNKNOWN_KEY,    ///< Key not in CONFIG_SCHEMA
+    BAD_NUMBER,     ///< Value is not a number of the field's type
+    OUT_OF_RANGE    ///< Number outside [minValue, maxValue]
+};
+
+/**
+ * @struct ConfigEntry
+ * @brief One non-comment line of a configuration file, as parsed
+ *
+ * key and value point into the parsed text, trimmed of blanks. For a
+ * MALFORMED_LINE key holds the whole line.
+ */
+struct ConfigEntry {
+    std::size_t line;               ///< 1-based line number
+    std::string_view key;
+    std::string_view value;
+    const ConfigField* field;       ///< Null unless the key is known
+    ConfigIssue issue;
+};
+
+/**
+ * @brief Applies the `key=value` lines of text to config
+ *
+ * Lines are applied in file order, so a repeated key keeps its last valid
+ * value. A value with an issue leaves the member unchanged.
+ *
+ * @param text Whole configuration file
+ * @param config Receives the valid values
+ * @param visit Called for every non-empty, non-comment line after it was
+ *              applied (may be empty)
+ * @return Number of lines with an issue
+ */
+std::size_t parseConfigText(std::string_view text, MachineConfig& config,
+                            const std::function<void(const ConfigEntry&)>& visit);
+
+#endif // LABELM_CONFIGSCHEMA_H
@@ -0,0 +1,58 @@
+/**
+ * @file labelm_configwatch.h
+ * @brief Notifies about changes of a configuration file (inotify)
+ *
+ * The directory of the file is watched rather than the file itself:
+ * editors and deployment tools usually write a temporary file and rename
+ * it over the original, which replaces the inode a file watch would be
+ * attached to.
+ */
+#ifndef LABELM_CONFIGWATCH_H
+#define LABELM_CONFIGWATCH_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * @class ConfigWatcher
+ * @brief Calls a function on its own thread whenever a file was rewritten
+ *
+ * Reacts to the file being closed after writing or renamed into place.
+ * Bursts of events (an editor saving in several steps) are collapsed
+ * into one call once the file has been quiet for the settle time.
+ */
+class ConfigWatcher {
+public:
+    /**
+     * @param path File to watch
+     * @param onChange Called from the watcher thread after each change
+     * @param settle Quiet time before onChange is called
+     */
+    ConfigWatcher(const std::string& path, std::function<void()> onChange,
+                  std::chrono::milliseconds settle = std::chrono::milliseconds(100));
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    /**
+     * @brief true if the watch is established and the thread is running
+     */
+    bool isWatching() const { return worker.joinable(); }
+
+private:
+    void run();
+
+    std::string directory;              ///< Watched directory
+    std::string name;                   ///< File name within directory
+    std::function<void()> onChange;
+    std::chrono::milliseconds settle;
+    int inotifyFd = -1;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
+
+#endif // LABELM_CONFIGWATCH_H
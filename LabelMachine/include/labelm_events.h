@@ -0,0 +1,302 @@
+/**
+ * @file labelm_events.h
+ * @brief Structured machine events and pluggable event sinks
+ *
+ * Every operator-facing message of the machine is a StatusEvent: a code
+ * plus a few numeric fields. Severity is a compile-time property of the
+ * code, and the EventDispatcher rejects events below the lowest threshold
+ * of its sinks before anything is formatted, so a machine whose console
+ * only shows warnings pays one compare per suppressed message.
+ */
+#ifndef LABELM_EVENTS_H
+#define LABELM_EVENTS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "labelm_spsc.h"
+#include "labelm_types.h"
+
+/**
+ * @enum EventSeverity
+ * @brief Importance of an event; sinks filter on a minimum severity
+ */
+enum class EventSeverity : std::uint8_t {
+    DEBUG,          ///< Per-product detail (sensor triggers)
+    INFO,           ///< Normal operation (labels applied, state changes)
+    WARNING,        ///< Rejected commands, low supplies
+    ERROR,          ///< Faults
+    OFF             ///< Threshold only: suppress everything
+};
+
+/**
+ * @enum EventCode
+ * @brief Identifies what happened; the payload meaning depends on the code
+ */
+enum class EventCode : std::uint16_t {
+    MACHINE_INITIALIZED,        ///< detail = firmware version
+    MACHINE_SHUTDOWN,
+    STARTED,                    ///< value1 = speed
+    START_REJECTED,
+    START_OVER_TEMPERATURE,     ///< measurement = temperature
+    START_NO_LABELS,
+    STOPPED,                    ///< value1 = products labeled
+    PAUSED,                     ///< value1 = products labeled, value2 = labels remaining
+    PAUSE_REJECTED,
+    RESUMED,                    ///< value1 = speed
+    RESUME_REJECTED,
+    RESUME_OVER_TEMPERATURE,    ///< measurement = temperature
+    RESUME_NO_LABELS,
+    MAINTENANCE_ENTERED,
+    MAINTENANCE_ENTER_REJECTED,
+    MAINTENANCE_EXITED,
+    MAINTENANCE_EXIT_REJECTED,
+    PRODUCT_DETECTED,
+    LABEL_APPLIED,              ///< value1 = product number, value2 = labels remaining
+    LABEL_FAILED,
+    LOW_LABEL_WARNING,          ///< value1 = labels remaining
+    LOW_LABEL_CLEARED,
+    SPEED_CHANGED,              ///< value1 = speed
+    SPEED_REJECTED,
+    SPEED_INVALID,              ///< value1 = requested, value2 = min, value3 = max
+    COUNTERS_RESET,
+    COUNTERS_RESET_REJECTED,
+    ROLL_LOADED,                ///< value1 = labels
+    ROLL_INVALID,
+    ERROR_CLEARED,
+    LOG_OPENED,                 ///< detail = path
+    LOG_OPEN_FAILED,            ///< detail = path
+    LOG_NOT_OPEN,
+    LOG_CLOSED,                 ///< detail = path, value1 = products labeled
+    LOG_REPLAYED,               ///< detail = path, value1 = rows, value2 = products labeled, value3 = errors
+    LOG_REPLAY_FAILED,          ///< detail = reason
+    CONFIG_FILE_MISSING,        ///< detail = path
+    CONFIG_DEFAULTS,
+    CONFIG_LOADING,             ///< detail = path
+    CONFIG_VALUE,               ///< detail = "key = value"
+    CONFIG_VALUE_INVALID,       ///< detail = key, measurement = value kept, value1 = line
+    CONFIG_LINE_IGNORED,        ///< detail = key or line text, value1 = line
+    CONFIG_COMPLETE,
+    CONFIG_RELOADED,            ///< detail = path
+    CONFIG_RELOAD_REJECTED,     ///< detail = reason, value1/value2 = offending values
+    CONFIG_WATCHING,            ///< detail = path
+    CONFIG_WATCH_FAILED,        ///< detail = path
+    STATUS_BLOCK_OPENED,        ///< detail = shared-memory name
+    STATUS_BLOCK_FAILED,        ///< detail = shared-memory name
+    METRICS_SERVING,            ///< value1 = port
+    METRICS_FAILED,             ///< value1 = requested port
+    LATENCY_SUMMARY,            ///< detail = operation and calls, value1/2/3 = p50/p99/p99.9 ns, measurement = max ns
+    TRACE_WRITTEN,              ///< detail = path, value1 = events written, value2 = events dropped
+    TRACE_WRITE_FAILED,         ///< detail = path (or reason)
+    COUNTERS_RESTORED,          ///< detail = checkpoint path, value1/2/3 = products labeled/errors/labels left
+    CHECKPOINT_FAILED,          ///< detail = checkpoint path
+    BATCH_STARTED,              ///< detail = batch id, value1 = quantity, value2 = orders still queued
+    BATCH_COMPLETED,            ///< detail = batch id, value1 = products labeled
+    BATCH_CANCELLED,            ///< detail = batch id, value1 = products labeled, value2 = quantity
+    BATCH_REJECTED,             ///< detail = reason, value1 = quantity, value2 = roll labels
+    WORK_ORDER_QUEUED,          ///< detail = batch id, value1 = quantity, value2 = orders queued
+    ROLL_CHANGE_STAGED,         ///< detail = next batch id, value1 = roll labels, value2 = labels left in this batch
+    BATCH_QUEUE_EMPTY,
+    ROLL_CHANGE_DUE,            ///< value1 = forecast seconds to empty, value2 = labels left, measurement = labels/min
+    SPEED_RAMP_STARTED,         ///< value1 = from speed, value2 = target speed, value3 = RampProfile, measurement = duration in s
+    SPEED_RAMP_COMPLETE,        ///< value1 = speed
+    SPEED_RAMP_CANCELLED,       ///< value1 = speed reached, value2 = target speed
+    COUNT                       ///< Number of codes (not an event)
+};
+
+/**
+ * @brief Severity of an event code
+ *
+ * constexpr so that the severity filter in front of a constant code folds
+ * to a single compare against the dispatcher threshold.
+ */
+constexpr EventSeverity eventSeverity(EventCode code) {
+    switch (code) {
+        case EventCode::PRODUCT_DETECTED:
+            return EventSeverity::DEBUG;
+        case EventCode::START_REJECTED:
+        case EventCode::PAUSE_REJECTED:
+        case EventCode::RESUME_REJECTED:
+        case EventCode::RESUME_NO_LABELS:
+        case EventCode::MAINTENANCE_ENTER_REJECTED:
+        case EventCode::MAINTENANCE_EXIT_REJECTED:
+        case EventCode::LOW_LABEL_WARNING:
+        case EventCode::SPEED_REJECTED:
+        case EventCode::COUNTERS_RESET_REJECTED:
+        case EventCode::CONFIG_FILE_MISSING:
+        case EventCode::CONFIG_VALUE_INVALID:
+        case EventCode::CONFIG_LINE_IGNORED:
+        case EventCode::LOG_REPLAY_FAILED:
+        case EventCode::CONFIG_RELOAD_REJECTED:
+        case EventCode::CONFIG_WATCH_FAILED:
+        case EventCode::STATUS_BLOCK_FAILED:
+        case EventCode::METRICS_FAILED:
+        case EventCode::TRACE_WRITE_FAILED:
+        case EventCode::CHECKPOINT_FAILED:
+        case EventCode::BATCH_REJECTED:
+        case EventCode::ROLL_CHANGE_DUE:
+            return EventSeverity::WARNING;
+        case EventCode::START_OVER_TEMPERATURE:
+        case EventCode::START_NO_LABELS:
+        case EventCode::RESUME_OVER_TEMPERATURE:
+        case EventCode::LABEL_FAILED:
+        case EventCode::SPEED_INVALID:
+        case EventCode::ROLL_INVALID:
+        case EventCode::LOG_OPEN_FAILED:
+        case EventCode::LOG_NOT_OPEN:
+            return EventSeverity::ERROR;
+        default:
+            return EventSeverity::INFO;
+    }
+}
+
+/**
+ * @struct StatusEvent
+ * @brief One machine event (plain data)
+ *
+ * `machineId` and `detail` point into storage owned by the emitter; they
+ * are valid while the event is being dispatched and, for machineId, for
+ * the lifetime of the machine. Sinks that keep events must not rely on
+ * `detail` afterwards.
+ */
+struct StatusEvent {
+    std::int64_t timestampNs;       ///< Wall-clock time, ns since the Unix epoch
+    EventCode code;
+    EventSeverity severity;
+    MachineState state;             ///< Machine state after the event
+    std::int32_t value1;
+    std::int32_t value2;
+    std::int32_t value3;
+    double measurement;
+    const char* machineId;
+    const char* detail;
+};
+
+/**
+ * @brief Renders the operator message for an event (no trailing newline)
+ *
+ * @return Number of characters written, 0 if the buffer is too small
+ */
+std::size_t formatEvent(const StatusEvent& event, char* buffer, std::size_t size);
+
+/**
+ * @class EventSink
+ * @brief Consumer of machine events
+ *
+ * A machine calls its sinks only from the thread that owns it; events of
+ * background work (a configuration reload) are handed over to that thread
+ * first. A sink attached to several machines on different threads must be
+ * thread-safe.
+ */
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+    virtual void consume(const StatusEvent& event) = 0;
+};
+
+/**
+ * @class ConsoleEventSink
+ * @brief Prints events as `[TAG] message` lines (log-file errors go to stderr)
+ */
+class ConsoleEventSink : public EventSink {
+public:
+    void consume(const StatusEvent& event) override;
+};
+
+/**
+ * @class NullEventSink
+ * @brief Discards all events
+ */
+class NullEventSink : public EventSink {
+public:
+    void consume(const StatusEvent&) override {}
+};
+
+/**
+ * @class RingBufferEventSink
+ * @brief Queues events for another thread without locking
+ *
+ * The machine's control thread is the single producer; one consumer
+ * thread reads events with poll(). When the ring is full new events are
+ * dropped and counted.
+ */
+class RingBufferEventSink : public EventSink {
+public:
+    explicit RingBufferEventSink(std::size_t capacity = 1024);
+
+    void consume(const StatusEvent& event) override;
+
+    /**
+     * @brief Takes the oldest queued event
+     * @return false if no event is queued
+     */
+    bool poll(StatusEvent& event);
+
+    /**
+     * @brief Number of events dropped because the ring was full
+     */
+    std::uint64_t dropped() const;
+
+private:
+    SpscRing<StatusEvent> ring;
+    std::atomic<std::uint64_t> droppedCount{0};
+};
+
+/**
+ * @class CallbackEventSink
+ * @brief Forwards events to a user function (called on the emitting thread)
+ */
+class CallbackEventSink : public EventSink {
+public:
+    explicit CallbackEventSink(std::function<void(const StatusEvent&)> callback);
+    void consume(const StatusEvent& event) override;
+
+private:
+    std::function<void(const StatusEvent&)> callback;
+};
+
+/**
+ * @class EventDispatcher
+ * @brief Fans events out to sinks, each with its own minimum severity
+ *
+ * wants() compares against the lowest threshold of all sinks and is meant
+ * to be checked before an event is built.
+ */
+class EventDispatcher {
+public:
+    /**
+     * @brief Attaches a sink
+     * @param sink Sink to receive events (shared so callers can keep reading it)
+     * @param minSeverity Events below this severity are not delivered to the sink
+     */
+    void addSink(std::shared_ptr<EventSink> sink, EventSeverity minSeverity);
+
+    /**
+     * @brief Detaches all sinks
+     */
+    void clear();
+
+    /**
+     * @brief Checks whether any sink accepts events of this severity
+     */
+    bool wants(EventSeverity severity) const { return severity >= threshold; }
+
+    /**
+     * @brief Delivers an event to every sink whose threshold it meets
+     */
+    void dispatch(const StatusEvent& event) const;
+
+private:
+    struct Entry {
+        std::shared_ptr<EventSink> sink;
+        EventSeverity minSeverity;
+    };
+    std::vector<Entry> sinks;
+    EventSeverity threshold = EventSeverity::OFF;   ///< Lowest sink threshold
+};
+
+#endif // LABELM_EVENTS_H
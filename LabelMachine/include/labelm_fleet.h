@@ -0,0 +1,191 @@
+/**
+ * @file labelm_fleet.h
+ * @brief Runs many labeling lines in parallel on a set of worker threads
+ */
+#ifndef LABELM_FLEET_H
+#define LABELM_FLEET_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "labelmachine.h"
+#include "labelm_spsc.h"
+
+/**
+ * @enum LineCommandType
+ * @brief Sensor events and operator commands routed to one line
+ */
+enum class LineCommandType : std::uint8_t {
+    PRODUCT_DETECTED,   ///< detectProduct(true)
+    PRODUCT_CLEARED,    ///< detectProduct(false)
+    LOAD_LABEL_ROLL,    ///< loadLabelRoll(value)
+    START,              ///< start()
+    STOP,               ///< stop()
+    PAUSE,              ///< pause()
+    RESUME              ///< resume()
+};
+
+/**
+ * @struct LineCommand
+ * @brief One queued event for a line (plain data)
+ */
+struct LineCommand {
+    LineCommandType type;
+    std::int32_t value;         ///< Argument (LOAD_LABEL_ROLL)
+    std::int64_t enqueuedNs;    ///< steady_clock time of postCommand()
+};
+
+/**
+ * @struct FleetOptions
+ * @brief Configuration of a FleetController
+ */
+struct FleetOptions {
+    std::size_t lineCount = 4;                  ///< Number of machines
+    std::size_t workerThreads = 0;              ///< 0: one per hardware thread (never more than lines)
+    std::size_t queueCapacity = 1024;           ///< Per-line command queue size
+    bool pinThreads = true;                     ///< Pin worker i to CPU i (Linux only)
+    std::string configFile = "machine_config.txt";  ///< loadConfig() file for every machine
+    MachineOptions machine;                     ///< Template; id, log path and checkpoint path are made unique per line
+};
+
+/**
+ * @struct LineStats
+ * @brief Counters and latency of one line
+ *
+ * Latency is measured from postCommand() to the end of the machine call
+ * on the worker thread.
+ */
+struct LineStats {
+    std::string machineId;
+    std::uint64_t commandsProcessed = 0;
+    std::uint64_t commandsDropped = 0;      ///< Rejected because the line queue was full
+    int productsLabeled = 0;
+    double meanLatencyUs = 0.0;
+    double p99LatencyUs = 0.0;              ///< Upper bound of the p99 power-of-two bucket
+    double maxLatencyUs = 0.0;
+    int labelRollRemaining = 0;
+    double secondsToEmpty = -1.0;           ///< Roll forecast as of the line's last command (-1: not known yet)
+};
+
+/**
+ * @struct RollChangeDue
+ * @brief One line in a fleet roll-change schedule
+ */
+struct RollChangeDue {
+    std::size_t line;
+    std::string machineId;
+    int labelRollRemaining;
+    double secondsToEmpty;                  ///< Forecast production time until the roll is empty
+};
+
+/**
+ * @struct FleetStats
+ * @brief Aggregate throughput of the fleet
+ */
+struct FleetStats {
+    std::size_t lines = 0;
+    std::size_t workers = 0;
+    double elapsedSeconds = 0.0;            ///< Since start() (until stop() once stopped)
+    std::uint64_t commandsProcessed = 0;
+    std::uint64_t productsLabeled = 0;
+    double commandsPerSecond = 0.0;
+    double labelsPerSecond = 0.0;
+};
+
+/**
+ * @class FleetController
+ * @brief Owns N LabelingMachine instances and drives them on worker threads
+ *
+ * Lines are sharded round-robin across the workers; every machine is only
+ * ever touched by its worker thread after start(), which keeps the
+ * single-threaded LabelingMachine contract without any locking. Events
+ * reach a line through its own SPSC command queue.
+ *
+ * Thread Safety: postCommand() for a given line must come from one thread
+ * at a time (different lines may be fed from different threads).
+ * lineStats()/stats() may be called from any thread.
+ */
+class FleetController {
+public:
+    explicit FleetController(const FleetOptions& options);
+    ~FleetController();
+
+    FleetController(const FleetController&) = delete;
+    FleetController& operator=(const FleetController&) = delete;
+
+    /**
+     * @brief Starts the worker threads and the machines
+     * @return false if already running
+     */
+    bool start();
+
+    /**
+     * @brief Drains all queues, stops the machines and joins the workers
+     */
+    void stop();
+
+    /**
+     * @brief Queues a command for one line
+     * @return false if the line does not exist or its queue is full
+     */
+    bool postCommand(std::size_t line, LineCommandType type, std::int32_t value = 0);
+
+    /**
+     * @brief Shortcut for PRODUCT_DETECTED / PRODUCT_CLEARED
+     */
+    bool postSensorEvent(std::size_t line, bool detected) {
+        return postCommand(line, detected ? LineCommandType::PRODUCT_DETECTED : LineCommandType::PRODUCT_CLEARED);
+    }
+
+    std::size_t lineCount() const { return lines.size(); }
+    std::size_t workerCount() const { return workerTotal; }
+
+    LineStats lineStats(std::size_t line) const;
+    FleetStats stats() const;
+
+    /**
+     * @brief Lines whose roll is forecast to run out within horizon, soonest first
+     *
+     * Lets an operator change all rolls due in the next round in one pass
+     * instead of reacting to each line's warning (or ERROR stop) in turn.
+     * Lines without a forecast yet are left out.
+     */
+    std::vector<RollChangeDue> rollChangeSchedule(std::chrono::seconds horizon) const;
+
+private:
+    static constexpr std::size_t LATENCY_BUCKETS = 40;  ///< Power-of-two ns buckets
+
+    struct Line {
+        Line(const MachineOptions& options, std::size_t queueCapacity);
+
+        std::unique_ptr<LabelingMachine> machine;
+        SpscRing<LineCommand> queue;
+        std::atomic<std::uint64_t> processed{0};
+        std::atomic<std::uint64_t> dropped{0};
+        std::atomic<int> labeled{0};
+        std::atomic<int> labelsRemaining{0};
+        std::atomic<double> secondsToEmpty{-1.0};
+        std::atomic<std::uint64_t> latencySumNs{0};
+        std::atomic<std::uint64_t> latencyMaxNs{0};
+        std::atomic<std::uint64_t> latencyBuckets[LATENCY_BUCKETS] = {};
+    };
+
+    void runWorker(std::size_t worker);
+    void execute(Line& line, const LineCommand& command);
+
+    FleetOptions options;
+    std::vector<std::unique_ptr<Line>> lines;
+    std::size_t workerTotal = 0;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running{false};
+    std::atomic<std::int64_t> startedNs{0};     ///< steady_clock ns at start()
+    std::atomic<std::int64_t> stoppedNs{0};     ///< steady_clock ns at stop(), 0 while running
+};
+
+#endif // LABELM_FLEET_H
@@ -0,0 +1,90 @@
+/**
+ * @file labelm_forecast.h
+ * @brief Forecast of when the label roll runs out
+ *
+ * RollForecaster tracks the time between applied labels as an
+ * exponentially weighted moving average. Intervals longer than
+ * MAX_INTERVAL_NS are stoppages (pause, product gap, roll change) rather
+ * than consumption and are not sampled, so the forecast is production
+ * time to empty: how long the line can keep labeling at its recent pace.
+ */
+#ifndef LABELM_FORECAST_H
+#define LABELM_FORECAST_H
+
+#include <cstdint>
+
+/**
+ * @struct RollForecast
+ * @brief Predicted consumption of the current roll
+ */
+struct RollForecast {
+    int labelsRemaining = 0;
+    double labelsPerMinute = 0.0;       ///< Recent consumption rate (0: not known yet)
+    double secondsToEmpty = -1.0;       ///< Production time until the roll is empty (-1: not known yet)
+    std::int64_t emptyAtNs = 0;         ///< Machine-clock time the roll runs out if production continues (0: not known)
+};
+
+/**
+ * @class RollForecaster
+ * @brief EWMA of the label interval of one machine
+ */
+class RollForecaster {
+public:
+    /// Weight of the newest interval in the average (about the last 16 labels dominate)
+    static constexpr double SMOOTHING = 1.0 / 16.0;
+    /// Longer intervals are stoppages, not consumption
+    static constexpr std::int64_t MAX_INTERVAL_NS = 10'000'000'000;
+    /// Intervals sampled before the forecast is trusted
+    static constexpr int WARMUP_SAMPLES = 8;
+
+    /**
+     * @brief Records an applied label
+     */
+    void onLabel(std::int64_t nowNs) {
+        const std::int64_t interval = nowNs - lastLabelNs;
+        if (lastLabelNs != 0 && interval > 0 && interval <= MAX_INTERVAL_NS) {
+            averageIntervalNs = samples == 0 ? static_cast<double>(interval)
+                                             : averageIntervalNs + SMOOTHING * (interval - averageIntervalNs);
+            samples++;
+        }
+        lastLabelNs = nowNs;
+    }
+
+    /**
+     * @brief true once WARMUP_SAMPLES intervals were sampled
+     */
+    bool isReady() const { return samples >= WARMUP_SAMPLES; }
+
+    /**
+     * @brief Recent consumption rate (0 if not ready)
+     */
+    double labelsPerMinute() const { return isReady() ? 60e9 / averageIntervalNs : 0.0; }
+
+    /**
+     * @brief Production time in seconds until labelsRemaining are used up (-1 if not ready)
+     */
+    double secondsToEmpty(int labelsRemaining) const {
+        return isReady() ? labelsRemaining * averageIntervalNs / 1e9 : -1.0;
+    }
+
+    /**
+     * @brief Full forecast for the labels on the roll
+     */
+    RollForecast forecast(int labelsRemaining, std::int64_t nowNs) const;
+
+    /**
+     * @brief Forgets the consumption history
+     */
+    void reset() {
+        lastLabelNs = 0;
+        averageIntervalNs = 0.0;
+        samples = 0;
+    }
+
+private:
+    std::int64_t lastLabelNs = 0;       ///< Time of the previous label (0: none)
+    double averageIntervalNs = 0.0;
+    int samples = 0;
+};
+
+#endif // LABELM_FORECAST_H
@@ -0,0 +1,108 @@
+/**
+ * @file labelm_journal.h
+ * @brief Compact binary production journal (fixed-width records)
+ *
+ * File layout: one JournalHeader followed by JournalRecord entries, all in
+ * host (little-endian) byte order. Each label costs 16 bytes instead of a
+ * ~40 byte CSV row, and records can be scanned or indexed without parsing.
+ * The `labelm-export` tool converts a journal back to the CSV layout.
+ */
+#ifndef LABELM_JOURNAL_H
+#define LABELM_JOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "labelm_logger.h"
+
+/**
+ * @struct JournalHeader
+ * @brief First 16 bytes of a journal file
+ */
+struct JournalHeader {
+    char magic[4];              ///< "LMJ1"
+    std::uint16_t version;      ///< Format version (JOURNAL_VERSION)
+    std::uint16_t recordSize;   ///< sizeof(JournalRecord)
+    std::uint64_t reserved;     ///< Zero
+};
+
+/**
+ * @struct JournalRecord
+ * @brief One label event, 16 bytes
+ *
+ * `packed` holds the conveyor speed (bits 0-11, mm/s, clamped to 4095),
+ * the LogStatus (bit 12) and the MachineState (bits 13-15).
+ */
+struct JournalRecord {
+    std::int64_t timestampNs;       ///< ns since the Unix epoch
+    std::int32_t productId;         ///< Product the record refers to
+    std::int16_t temperatureDeci;   ///< Temperature in 0.1 °C
+    std::uint16_t packed;           ///< Speed | status | state
+};
+
+static_assert(sizeof(JournalHeader) == 16, "journal header must stay 16 bytes");
+static_assert(sizeof(JournalRecord) == 16, "journal record must stay 16 bytes");
+
+constexpr char JOURNAL_MAGIC[4] = {'L', 'M', 'J', '1'};
+constexpr std::uint16_t JOURNAL_VERSION = 1;
+
+/**
+ * @brief Packs a log record into its 16-byte journal form
+ */
+JournalRecord encodeJournalRecord(const LogRecord& record);
+
+/**
+ * @brief Expands a journal record back into a log record
+ */
+LogRecord decodeJournalRecord(const JournalRecord& record);
+
+/**
+ * @class BinaryJournalSink
+ * @brief LogSink that appends JournalRecords through a preallocated buffer
+ *
+ * Records are encoded into an in-memory block and written to the file in
+ * one call when the block fills up or flush() is called. The file is
+ * truncated and the header written on construction.
+ */
+class BinaryJournalSink : public LogSink {
+public:
+    /**
+     * @param path Journal file to create
+     * @param bufferRecords Number of records buffered between writes
+     */
+    explicit BinaryJournalSink(const std::string& path, std::size_t bufferRecords = 4096);
+    ~BinaryJournalSink() override;
+
+    bool isOpen() const override;
+    void write(const LogRecord& record) override;
+    void flush() override;
+    LogWriterStats stats() const override;
+
+private:
+    void writeBuffer();
+
+    std::ofstream file;                 ///< Output stream (binary)
+    std::vector<JournalRecord> buffer;  ///< Preallocated record block
+    std::size_t used = 0;               ///< Records currently in buffer
+    std::uint64_t written = 0;          ///< Records handed to write()
+};
+
+/**
+ * @brief Reads all records of a journal file
+ *
+ * Records are read in large blocks and passed to the callback one by one.
+ *
+ * @param path Journal file
+ * @param callback Invoked for each decoded record in file order
+ * @param error Receives a description if the file cannot be read
+ * @return true if the whole file was read, false on error
+ */
+bool readJournal(const std::string& path,
+                 const std::function<void(const LogRecord&)>& callback,
+                 std::string& error);
+
+#endif // LABELM_JOURNAL_H
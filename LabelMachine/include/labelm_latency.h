@@ -0,0 +1,173 @@
+/**
+ * @file labelm_latency.h
+ * @brief Per-operation latency histograms with log-linear (HDR-style) buckets
+ *
+ * Durations are sampled with std::chrono::steady_clock (a vDSO read of the
+ * TSC on Linux/x86, ~20 ns) and counted in log-linear buckets: 16 linear
+ * sub-buckets per power of two, so any value is known to within 1/16
+ * (6.25 %) from 1 ns up to ~18 minutes in a fixed 4.8 KB per operation.
+ *
+ * Recording touches only the calling thread's shard with relaxed atomic
+ * increments; shards are merged when a summary is read.
+ */
+#ifndef LABELM_LATENCY_H
+#define LABELM_LATENCY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum MetricOperation
+ * @brief Machine operations with a latency histogram
+ */
+enum class MetricOperation : std::uint8_t {
+    LABEL,          ///< applyLabel()
+    START,
+    STOP,
+    PAUSE,
+    RESUME,
+    SET_SPEED,
+    LOAD_ROLL,
+    ENTER_MAINTENANCE,
+    EXIT_MAINTENANCE,
+    DETECT_PRODUCT, ///< detectProduct(), including the label it triggers
+    LOG_ENTRY,      ///< logEntry(): hand-off of a record to the log sink
+    TRANSITION,     ///< transition() through the state table, including hooks
+    COUNT           ///< Number of operations (not an operation)
+};
+
+constexpr std::size_t METRIC_OPERATION_COUNT = static_cast<std::size_t>(MetricOperation::COUNT);
+
+/**
+ * @brief Short lower-case name of an operation ("label", "set_speed", ...)
+ */
+const char* metricOperationName(MetricOperation operation);
+
+/// Linear sub-buckets per power of two (2^LATENCY_SUB_BITS)
+constexpr unsigned LATENCY_SUB_BITS = 4;
+constexpr std::size_t LATENCY_SUB_BUCKETS = std::size_t(1) << LATENCY_SUB_BITS;
+/// Highest power of two resolved (2^40 ns ~ 18 min); larger values share the last bucket
+constexpr unsigned LATENCY_MAX_EXPONENT = 40;
+constexpr std::size_t LATENCY_BUCKETS = (LATENCY_MAX_EXPONENT - LATENCY_SUB_BITS + 2) * LATENCY_SUB_BUCKETS;
+
+/**
+ * @brief Bucket of a duration in ns
+ */
+inline std::size_t latencyBucket(std::uint64_t ns) {
+    if (ns < LATENCY_SUB_BUCKETS) {
+        return static_cast<std::size_t>(ns);
+    }
+    const unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(ns));
+    if (exponent > LATENCY_MAX_EXPONENT) {
+        return LATENCY_BUCKETS - 1;
+    }
+    const unsigned shift = exponent - LATENCY_SUB_BITS;
+    return (shift + 1) * LATENCY_SUB_BUCKETS + static_cast<std::size_t>((ns >> shift) - LATENCY_SUB_BUCKETS);
+}
+
+/**
+ * @brief Largest duration in ns counted in a bucket
+ */
+inline std::uint64_t latencyBucketUpperNs(std::size_t bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    const unsigned shift = static_cast<unsigned>(bucket / LATENCY_SUB_BUCKETS) - 1;
+    const std::uint64_t sub = bucket % LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+/**
+ * @struct LatencySummary
+ * @brief Merged distribution of one operation
+ *
+ * Percentiles are bucket upper bounds (at most 6.25 % high), capped at maxNs.
+ */
+struct LatencySummary {
+    std::uint64_t count = 0;
+    double meanNs = 0.0;
+    std::uint64_t p50Ns = 0;
+    std::uint64_t p99Ns = 0;
+    std::uint64_t p999Ns = 0;
+    std::uint64_t maxNs = 0;
+    std::uint64_t sumNs = 0;
+    std::array<std::uint64_t, LATENCY_BUCKETS> buckets{};   ///< Merged bucket counts
+};
+
+/**
+ * @class LatencyRecorder
+ * @brief Latency histograms of all operations of one machine
+ *
+ * Threads are spread over SHARDS shards by a per-thread index; a shard is
+ * allocated on its first use. Threads that share a shard still count
+ * correctly (atomic increments), they just contend.
+ */
+class LatencyRecorder {
+public:
+    static constexpr std::size_t SHARDS = 8;
+
+    LatencyRecorder() = default;
+    ~LatencyRecorder();
+
+    LatencyRecorder(const LatencyRecorder&) = delete;
+    LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+
+    /**
+     * @brief Counts one duration of an operation (any thread)
+     */
+    void record(MetricOperation operation, std::uint64_t ns);
+
+    /**
+     * @brief Merges all shards of an operation
+     */
+    LatencySummary summary(MetricOperation operation) const;
+
+private:
+    struct Histogram {
+        std::array<std::atomic<std::uint64_t>, LATENCY_BUCKETS> buckets{};
+        std::atomic<std::uint64_t> sumNs{0};
+        std::atomic<std::uint64_t> maxNs{0};
+    };
+    struct Shard {
+        std::array<Histogram, METRIC_OPERATION_COUNT> operations;
+    };
+
+    Shard& shardOfThisThread();
+
+    std::array<std::atomic<Shard*>, SHARDS> shards{};
+};
+
+/**
+ * @class OperationTimer
+ * @brief Records the duration of a scope into a LatencyRecorder
+ *
+ * Does nothing (no clock read) when the recorder is null.
+ */
+class OperationTimer {
+public:
+    OperationTimer(LatencyRecorder* recorder, MetricOperation operation)
+        : recorder(recorder)
+        , operation(operation)
+        , start(recorder != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point())
+    {}
+
+    ~OperationTimer() {
+        if (recorder != nullptr) {
+            recorder->record(operation, static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        }
+    }
+
+    OperationTimer(const OperationTimer&) = delete;
+    OperationTimer& operator=(const OperationTimer&) = delete;
+
+private:
+    LatencyRecorder* recorder;
+    MetricOperation operation;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // LABELM_LATENCY_H
@@ -0,0 +1,280 @@
+/**
+ * @file labelm_logger.h
+ * @brief Production log records, sinks and the asynchronous log writer
+ *
+ * The labeling path only builds a fixed-size LogRecord and hands it to a
+ * LogSink. AsyncLogWriter is a LogSink that queues records in a bounded
+ * lock-free ring and lets a dedicated logger thread format, write and
+ * flush them, so applyLabel() never waits on the disk.
+ */
+#ifndef LABELM_LOGGER_H
+#define LABELM_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "labelm_spsc.h"
+#include "labelm_time.h"
+#include "labelm_types.h"
+
+class LogIndexWriter;
+class TraceRecorder;
+
+/**
+ * @enum LogStatus
+ * @brief Outcome of a label application as written to the production log
+ */
+enum class LogStatus : std::uint8_t {
+    SUCCESS,        ///< Label applied
+    FAILURE         ///< Label could not be applied (e.g. roll empty)
+};
+
+/**
+ * @brief Text used for a LogStatus in the CSV log
+ */
+const char* logStatusName(LogStatus status);
+
+/**
+ * @struct LogRecord
+ * @brief One production log row in binary form (plain data, no allocation)
+ */
+struct LogRecord {
+    std::int64_t timestampNs;   ///< Wall-clock time, ns since the Unix epoch
+    std::int32_t productId;     ///< Product the row refers to
+    std::int32_t conveyorSpeed; ///< Conveyor speed in mm/s
+    double temperature;         ///< System temperature in Celsius
+    LogStatus status;           ///< Label outcome
+    MachineState state;         ///< Machine state when the row was produced
+};
+
+/**
+ * @brief Formats a record as one CSV row (including the trailing newline)
+ *
+ * @param record Record to format
+ * @param formatter Timestamp cache of the calling thread
+ * @param buffer Output buffer (128 bytes is always enough)
+ * @param size Size of buffer in bytes
+ * @return Number of characters written, 0 on error
+ */
+std::size_t formatCsvRow(const LogRecord& record, TimestampFormatter& formatter, char* buffer, std::size_t size);
+
+/// CSV header row written at the top of every text production log
+constexpr const char* CSV_LOG_HEADER = "Timestamp,ProductID,Temperature,Speed,Status\n";
+
+/**
+ * @struct LogWriterStats
+ * @brief Record counters reported by a log sink
+ */
+struct LogWriterStats {
+    std::uint64_t queued = 0;   ///< Records accepted from the labeling path
+    std::uint64_t written = 0;  ///< Records written to the output
+    std::uint64_t dropped = 0;  ///< Records discarded because the queue was full
+};
+
+/**
+ * @class LogSink
+ * @brief Destination for production log records
+ */
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+
+    /**
+     * @brief Checks whether the sink can accept records
+     */
+    virtual bool isOpen() const = 0;
+
+    /**
+     * @brief Writes (or queues) one record
+     */
+    virtual void write(const LogRecord& record) = 0;
+
+    /**
+     * @brief Pushes buffered records to the underlying storage
+     */
+    virtual void flush() = 0;
+
+    /**
+     * @brief Flushes and returns once every record written so far is in the underlying storage
+     *
+     * Same as flush() for sinks that write synchronously.
+     */
+    virtual void sync() { flush(); }
+
+    /**
+     * @brief Returns record counters for this sink
+     */
+    virtual LogWriterStats stats() const = 0;
+};
+
+/**
+ * @class CsvLogSink
+ * @brief Writes records as `Timestamp,ProductID,Temperature,Speed,Status` rows
+ *
+ * By default the file is truncated and the CSV header written on
+ * construction. In append mode existing rows are kept and the header is
+ * only written to an empty file. Writes are buffered by the stream;
+ * flush() forces them to the file.
+ *
+ * With a non-zero indexInterval every indexInterval-th row is also
+ * recorded in the sparse time index `<path>.idx` (see labelm_logindex.h).
+ */
+class CsvLogSink : public LogSink {
+public:
+    explicit CsvLogSink(const std::string& path, bool append = false, std::size_t indexInterval = 0);
+    ~CsvLogSink() override;
+
+    bool isOpen() const override;
+    void write(const LogRecord& record) override;
+    void flush() override;
+    LogWriterStats stats() const override;
+
+    /// Bytes written so far, including the header (flushed or not)
+    std::uint64_t bytes() const { return offset; }
+
+private:
+    std::ofstream file;         ///< Output stream
+    TimestampFormatter timestampFormatter; ///< Cached timestamp prefix for rows
+    std::uint64_t written = 0;  ///< Rows written (excluding header)
+    std::uint64_t offset = 0;   ///< Byte offset of the next row
+    std::size_t indexInterval;  ///< Rows between index entries (0: no index)
+    std::unique_ptr<LogIndexWriter> index;
+};
+
+/**
+ * @enum OverflowPolicy
+ * @brief What the labeling path does when the log queue is full
+ */
+enum class OverflowPolicy {
+    DROP_NEWEST,    ///< Discard the new record and count it as dropped
+    BLOCK           ///< Spin (yielding) until the logger thread frees a slot
+};
+
+/**
+ * @struct FlushPolicy
+ * @brief When the logger thread flushes the target sink
+ *
+ * A flush happens as soon as any enabled condition is met. A value of 0
+ * disables the corresponding condition.
+ */
+struct FlushPolicy {
+    std::size_t everyRecords = 64;                  ///< Flush after this many records
+    std::chrono::milliseconds interval{100};        ///< Flush at least this often while records are pending
+    bool onStateChange = true;                      ///< Flush when a record's machine state differs from the previous one
+};
+
+/**
+ * @struct AsyncLogOptions
+ * @brief Tuning parameters for AsyncLogWriter
+ */
+struct AsyncLogOptions {
+    std::size_t queueCapacity = 4096;                   ///< Ring size (rounded up to a power of two)
+    OverflowPolicy overflow = OverflowPolicy::DROP_NEWEST;
+    FlushPolicy flush;
+    std::chrono::microseconds idleWait{500};            ///< Logger thread sleep when the queue is empty
+    TraceRecorder* trace = nullptr;                     ///< Records a span per flush (null: no tracing); must outlive the writer
+};
+
+/**
+ * @class AsyncLogWriter
+ * @brief LogSink that moves all I/O to a dedicated logger thread
+ *
+ * write() only copies the record into a lock-free SPSC ring and returns.
+ * The logger thread drains the ring into the target sink and flushes it
+ * according to the FlushPolicy. The destructor drains all queued records,
+ * flushes and joins the thread.
+ *
+ * Thread Safety: write() must always be called from the same thread
+ * (the machine's control thread). stats() may be called from anywhere.
+ */
+class AsyncLogWriter : public LogSink {
+public:
+    AsyncLogWriter(std::unique_ptr<LogSink> target, const AsyncLogOptions& options = AsyncLogOptions());
+    ~AsyncLogWriter() override;
+
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+    bool isOpen() const override;
+    void write(const LogRecord& record) override;
+
+    /**
+     * @brief Asks the logger thread to flush at its next opportunity
+     *
+     * Does not wait for the flush to complete.
+     */
+    void flush() override;
+
+    /**
+     * @brief Waits until the logger thread has written and flushed every queued record
+     *
+     * Call from the thread that calls write(). Dropped records are not waited for.
+     */
+    void sync() override;
+
+    LogWriterStats stats() const override;
+
+private:
+    void run();
+
+    std::unique_ptr<LogSink> target;        ///< Sink written by the logger thread
+    AsyncLogOptions options;                ///< Queue and flush configuration
+    SpscRing<LogRecord> queue;              ///< Labeling thread -> logger thread
+
+    std::atomic<bool> stopping{false};      ///< Set by the destructor
+    std::atomic<bool> flushRequested{false};///< Set by flush()
+    std::atomic<std::uint64_t> queued{0};
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> flushedThrough{0};   ///< Records written before the last completed flush
+
+    std::thread worker;                     ///< Logger thread (started last)
+};
+
+/**
+ * @enum LogFormat
+ * @brief On-disk format of the production log
+ */
+enum class LogFormat {
+    CSV,            ///< Text rows, `Timestamp,ProductID,Temperature,Speed,Status`
+    BINARY_JOURNAL, ///< 16-byte fixed-width records (see labelm_journal.h)
+    MAPPED_RING,    ///< Fixed-size memory-mapped ring of journal records (see labelm_ringlog.h)
+    DISABLED        ///< No production log (logEntry() does nothing)
+};
+
+/**
+ * @struct LogRotationOptions
+ * @brief Rotation of the CSV log into numbered segments (see labelm_rotation.h)
+ *
+ * Rotation is enabled when either limit is non-zero.
+ */
+struct LogRotationOptions {
+    std::uint64_t maxBytes = 0;             ///< Start a new segment at this size (0: no size limit)
+    std::chrono::seconds maxAge{0};         ///< Start a new segment after this much log time (0: no age limit)
+    std::size_t keepSegments = 0;           ///< Closed segments to keep; older ones are deleted (0: keep all)
+    bool compress = false;                  ///< gzip closed segments in the background (needs zlib)
+
+    bool enabled() const { return maxBytes > 0 || maxAge.count() > 0; }
+};
+
+/**
+ * @struct LogOptions
+ * @brief Selects and configures the production log opened by openLog()
+ */
+struct LogOptions {
+    LogFormat format = LogFormat::CSV;
+    std::string path;                   ///< Output file; empty selects the default for the format
+    AsyncLogOptions async;              ///< Logger thread configuration (CSV and BINARY_JOURNAL)
+    std::size_t ringCapacity = 65536;   ///< Records kept by MAPPED_RING
+    bool append = false;                ///< CSV: keep existing rows instead of truncating
+    std::size_t indexEveryRows = 1024;  ///< CSV: rows between time index entries (0: no index)
+    LogRotationOptions rotation;        ///< CSV: segment the log instead of one file
+};
+
+#endif // LABELM_LOGGER_H
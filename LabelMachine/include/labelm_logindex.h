@@ -0,0 +1,121 @@
+/**
+ * @file labelm_logindex.h
+ * @brief Sparse time index beside the CSV production log
+ *
+ * Every N rows CsvLogSink appends (timestamp, byte offset of the row) to
+ * `<log>.idx`. A time-range query binary-searches the index and reads
+ * only the part of the log that can contain matching rows, so looking up
+ * five minutes of a shift-long log touches a few kilobytes instead of the
+ * whole file.
+ *
+ * Index file layout (little-endian, native):
+ *   LogIndexHeader, then LogIndexEntry records in log order.
+ */
+#ifndef LABELM_LOGINDEX_H
+#define LABELM_LOGINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "labelm_replay.h"
+
+/// Magic bytes at the start of every log index file
+constexpr char LOG_INDEX_MAGIC[4] = {'L', 'M', 'X', '1'};
+constexpr std::uint16_t LOG_INDEX_VERSION = 1;
+
+/**
+ * @struct LogIndexHeader
+ * @brief 16-byte header of a log index file
+ */
+struct LogIndexHeader {
+    char magic[4];              ///< LOG_INDEX_MAGIC
+    std::uint16_t version;      ///< LOG_INDEX_VERSION
+    std::uint16_t entrySize;    ///< sizeof(LogIndexEntry)
+    std::uint32_t interval;     ///< Rows between entries
+    std::uint32_t reserved;
+};
+static_assert(sizeof(LogIndexHeader) == 16, "LogIndexHeader must stay 16 bytes");
+
+/**
+ * @struct LogIndexEntry
+ * @brief Timestamp and byte offset of one indexed log row
+ */
+struct LogIndexEntry {
+    std::int64_t timestampNs;   ///< Timestamp of the row
+    std::uint64_t offset;       ///< Byte offset of the row's first character
+};
+static_assert(sizeof(LogIndexEntry) == 16, "LogIndexEntry must stay 16 bytes");
+
+/**
+ * @brief Path of the index belonging to a CSV log (`<log>.idx`)
+ */
+std::string logIndexPath(const std::string& logPath);
+
+/**
+ * @class LogIndexWriter
+ * @brief Appends index entries for CsvLogSink
+ *
+ * Entries are buffered by the stream; flush() is called right after the
+ * log itself is flushed, so an entry never refers to data that is less
+ * durable than the entry.
+ */
+class LogIndexWriter {
+public:
+    /**
+     * @param path Index file
+     * @param interval Rows between entries (recorded in the header)
+     * @param append Keep existing entries (the log is appended to)
+     */
+    LogIndexWriter(const std::string& path, std::uint32_t interval, bool append);
+
+    bool isOpen() const { return file.is_open() && file.good(); }
+    void add(std::int64_t timestampNs, std::uint64_t offset);
+    void flush() { file.flush(); }
+
+private:
+    std::ofstream file;
+};
+
+/**
+ * @brief Loads all entries of an index file
+ * @return false if the file is missing or not a log index
+ */
+bool readLogIndex(const std::string& path, std::vector<LogIndexEntry>& entries, std::string& error);
+
+/**
+ * @brief Byte offset from which a scan for rows at or after timestampNs must start
+ *
+ * Binary search for the last entry before timestampNs; 0 if there is none.
+ */
+std::uint64_t findLogOffset(const std::vector<LogIndexEntry>& entries, std::int64_t timestampNs);
+
+/**
+ * @struct LogQueryStats
+ * @brief Work done by a queryCsvLog() call
+ */
+struct LogQueryStats {
+    std::uint64_t rowsMatched = 0;
+    std::uint64_t bytesScanned = 0;     ///< Log bytes read (not counting the index)
+    std::uint64_t startOffset = 0;      ///< Where the scan started
+    bool usedIndex = false;             ///< false if no index was found (full scan)
+};
+
+/**
+ * @brief Finds all rows with fromNs <= timestamp <= toNs
+ *
+ * Uses `<logPath>.idx` when present, otherwise scans from the start. The
+ * scan stops at the first row after toNs, so the log must be in time
+ * order (as written by one machine with a monotonic clock).
+ *
+ * @param callback Receives each matching row and its raw text (without newline)
+ * @return false if the log cannot be read
+ */
+bool queryCsvLog(const std::string& logPath, std::int64_t fromNs, std::int64_t toNs,
+                 const std::function<void(const CsvLogRow&, const char*, std::size_t)>& callback,
+                 std::string& error, LogQueryStats* stats = nullptr);
+
+#endif // LABELM_LOGINDEX_H
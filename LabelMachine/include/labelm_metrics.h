@@ -0,0 +1,102 @@
+/**
+ * @file labelm_metrics.h
+ * @brief Machine metrics and a Prometheus text-format endpoint
+ *
+ * MachineMetrics holds counters and gauges as relaxed atomics: the
+ * labeling path only stores into them. Latencies come from the machine's
+ * LatencyRecorder (labelm_latency.h). All formatting happens in
+ * appendMetricsText() when a scrape arrives on the MetricsServer thread.
+ *
+ * Exposed metrics (label machine="<id>"):
+ *   labelm_products_labeled_total, labelm_errors_total (counters, reset
+ *   with resetCounters()), labelm_label_roll_remaining,
+ *   labelm_temperature_celsius, labelm_conveyor_speed_mm_per_second,
+ *   labelm_state{state="..."} (1 for the current state),
+ *   labelm_operation_duration_seconds{operation="..."} (histogram).
+ */
+#ifndef LABELM_METRICS_H
+#define LABELM_METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "labelm_latency.h"
+
+/**
+ * @struct MachineMetrics
+ * @brief Current values of one machine's metrics
+ *
+ * Written by the labeling thread, read by the scrape thread; every access
+ * is relaxed, so a scrape may mix values of consecutive updates.
+ */
+struct MachineMetrics {
+    std::atomic<std::int64_t> productsLabeled{0};
+    std::atomic<std::int64_t> errorCount{0};
+    std::atomic<std::int32_t> labelRollRemaining{0};
+    std::atomic<double> temperature{0.0};
+    std::atomic<std::int32_t> conveyorSpeed{0};
+    std::atomic<std::uint8_t> state{0};     ///< MachineState
+};
+
+/**
+ * @brief Appends one machine's metrics in Prometheus text exposition format
+ *
+ * Histogram `le` bounds are decimal (250 ns .. 1 ms); a log-linear bucket
+ * is counted under the first bound at or above its upper end, so counts
+ * may lean up to one sub-bucket (6.25 %) towards the larger bound.
+ *
+ * @param latency Operation latencies (null: no histograms)
+ * @param withHelp Emit the # HELP/# TYPE lines (once per scrape when
+ *                 several machines are rendered into one response)
+ */
+void appendMetricsText(std::string& out, const std::string& machineId, const MachineMetrics& metrics,
+                       const LatencyRecorder* latency, bool withHelp = true);
+
+/**
+ * @class MetricsServer
+ * @brief Minimal HTTP endpoint serving `GET /metrics` on 127.0.0.1
+ *
+ * One thread multiplexes all connections with epoll. Each scrape calls
+ * render on that thread to produce the response body; other paths get
+ * 404; a query string after /metrics is ignored. Connections are closed
+ * after the response. A client gets 5 s from accept to send its request
+ * and read the response, and at most 64 connections are open at a time.
+ */
+class MetricsServer {
+public:
+    /**
+     * @param port TCP port on 127.0.0.1 (0: any free port, see port())
+     * @param render Fills the response body of a scrape
+     */
+    MetricsServer(std::uint16_t port, std::function<void(std::string&)> render);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief true if the socket is listening and the thread is running
+     */
+    bool isRunning() const { return worker.joinable(); }
+
+    /**
+     * @brief Port actually bound
+     */
+    std::uint16_t port() const { return boundPort; }
+
+private:
+    void run();
+
+    std::function<void(std::string&)> render;
+    int listenFd = -1;
+    int epollFd = -1;
+    std::uint16_t boundPort = 0;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
+
+#endif // LABELM_METRICS_H
@@ -0,0 +1,163 @@
+/**
+ * @file labelm_oee.h
+ * @brief Overall Equipment Effectiveness over sliding time windows
+ *
+ * OEE = availability x performance x quality:
+ *  - availability: labeling time / (labeling time + unplanned downtime).
+ *    RUNNING and LOW_LABEL count as labeling, PAUSED and ERROR as
+ *    downtime; IDLE and MAINTENANCE are not planned production time.
+ *  - performance: labels produced / labels possible at the ideal rate
+ *    (maxSpeed / productPitch) during the labeling time.
+ *  - quality: SUCCESS / (SUCCESS + FAILURE) label attempts.
+ *
+ * Each window (last minute, last 15 minutes, last shift) is a ring of
+ * fixed-size time buckets, so memory is bounded and no log is re-read.
+ */
+#ifndef LABELM_OEE_H
+#define LABELM_OEE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "labelm_types.h"
+
+/**
+ * @struct OeeFigures
+ * @brief OEE and its factors for one window
+ *
+ * Factors without a basis (e.g. performance with no labeling time) are 0.
+ */
+struct OeeFigures {
+    std::int64_t windowNs = 0;      ///< Length of the window
+    std::int64_t runNs = 0;         ///< Labeling time in the window
+    std::int64_t downNs = 0;        ///< PAUSED + ERROR time in the window
+    std::uint64_t good = 0;         ///< Labels applied
+    std::uint64_t rejected = 0;     ///< Failed label attempts
+    double idealCount = 0.0;        ///< Labels possible at the ideal rate in runNs
+    double availability = 0.0;
+    double performance = 0.0;
+    double quality = 0.0;
+    double oee = 0.0;               ///< availability * performance * quality
+};
+
+/**
+ * @struct OeeReport
+ * @brief OEE of all standard windows
+ */
+struct OeeReport {
+    OeeFigures lastMinute;
+    OeeFigures last15Minutes;
+    OeeFigures shift;
+};
+
+/**
+ * @class OeeWindow
+ * @brief Ring of time buckets covering one sliding window
+ *
+ * Bucket i holds the totals of absolute bucket number `epoch`; buckets
+ * whose epoch has left the window are ignored on read and recycled on
+ * write. The window covers the current bucket plus the bucketCount - 1
+ * before it.
+ */
+class OeeWindow {
+public:
+    OeeWindow(std::chrono::nanoseconds length, std::size_t bucketCount);
+
+    /**
+     * @brief Adds the time [fromNs, toNs) spent in one state category
+     * @param running true for labeling time, false for downtime
+     * @param idealPerNs Ideal production rate during the interval
+     */
+    void addTime(std::int64_t fromNs, std::int64_t toNs, bool running, double idealPerNs);
+
+    /**
+     * @brief Counts one label attempt at timeNs
+     */
+    void addLabel(std::int64_t timeNs, bool success);
+
+    /**
+     * @brief Sums the window ending at nowNs, plus an interval not yet added
+     *
+     * @param openSinceNs Start of the still-open state interval
+     * @param openRunning/openDown Category of the open interval
+     * @param idealPerNs Ideal rate for the open interval
+     */
+    OeeFigures figures(std::int64_t nowNs, std::int64_t openSinceNs, bool openRunning,
+                       bool openDown, double idealPerNs) const;
+
+    void clear();
+
+private:
+    struct Bucket {
+        std::int64_t epoch = -1;    ///< Absolute bucket number (time / bucketNs)
+        std::int64_t runNs = 0;
+        std::int64_t downNs = 0;
+        std::uint64_t good = 0;
+        std::uint64_t rejected = 0;
+        double idealCount = 0.0;
+    };
+
+    Bucket& bucketFor(std::int64_t epoch);
+    std::int64_t windowStart(std::int64_t nowNs) const;
+
+    std::int64_t bucketNs;
+    std::vector<Bucket> buckets;
+};
+
+/**
+ * @class OeeCalculator
+ * @brief Feeds machine transitions and labels into the 1 min / 15 min / shift windows
+ *
+ * Updates cost O(buckets crossed since the last update) and report() is
+ * O(bucket count); both are independent of how long the machine has run.
+ *
+ * Thread Safety: NOT thread-safe; owned by the machine's control thread.
+ */
+class OeeCalculator {
+public:
+    /// Buckets per window: 1 s resolution for the last minute, 15 s for
+    /// 15 minutes and shift length / 60 for the shift
+    static constexpr std::size_t BUCKETS_PER_WINDOW = 60;
+
+    explicit OeeCalculator(std::chrono::nanoseconds shiftLength = std::chrono::hours(8));
+
+    /**
+     * @brief Clears all windows and starts accounting at nowNs
+     */
+    void reset(std::int64_t nowNs, MachineState state);
+
+    /**
+     * @brief Sets the ideal production rate (labels per second)
+     */
+    void setIdealRate(double labelsPerSecond, std::int64_t nowNs);
+
+    /**
+     * @brief Closes the interval of the previous state
+     */
+    void onTransition(MachineState to, std::int64_t nowNs);
+
+    /**
+     * @brief Counts a label attempt (quality) and its output (performance)
+     */
+    void onLabel(bool success, std::int64_t nowNs);
+
+    /**
+     * @brief OEE of all windows ending at nowNs
+     */
+    OeeReport report(std::int64_t nowNs) const;
+
+private:
+    void accrue(std::int64_t nowNs);
+
+    OeeWindow minute;
+    OeeWindow quarterHour;
+    OeeWindow shift;
+
+    std::int64_t sinceNs = 0;               ///< Start of the interval not yet added
+    MachineState state = MachineState::IDLE;
+    double idealPerNs = 0.0;
+};
+
+#endif // LABELM_OEE_H
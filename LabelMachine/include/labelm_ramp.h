@@ -0,0 +1,182 @@
+/**
+ * @file labelm_ramp.h
+ * @brief Conveyor speed ramps advanced by a shared control tick
+ *
+ * A RampPlan describes how the speed moves from one value to another:
+ * TRAPEZOIDAL accelerates at a constant rate, S_CURVE additionally limits
+ * the jerk so the acceleration itself builds up and dies down smoothly
+ * (no shock to products standing on the belt). Plans are pure functions
+ * of time.
+ *
+ * A RampEngine owns one timer thread that advances every active ramp on
+ * each tick and publishes its setpoint; callers only register a ramp and
+ * return. One engine serves any number of machines; the thread sleeps
+ * while no ramp is active.
+ *
+ * Ramp time runs on a MachineClock when one is given, so a machine on a
+ * SimulationClock ramps in simulated time. The tick itself is wall time:
+ * it only decides how often setpoints are published.
+ */
+#ifndef LABELM_RAMP_H
+#define LABELM_RAMP_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "labelm_time.h"
+
+/**
+ * @enum RampProfile
+ * @brief Shape of a speed ramp
+ */
+enum class RampProfile : std::uint8_t {
+    TRAPEZOIDAL,    ///< Constant acceleration (speed changes linearly)
+    S_CURVE         ///< Jerk-limited acceleration (speed changes smoothly)
+};
+
+/**
+ * @struct RampPlan
+ * @brief Speed profile from one speed to another
+ */
+struct RampPlan {
+    int fromSpeed = 0;                  ///< mm/s
+    int toSpeed = 0;                    ///< mm/s
+    RampProfile profile = RampProfile::S_CURVE;
+    double acceleration = 100.0;        ///< Largest acceleration, mm/s^2 (> 0)
+    double jerk = 500.0;                ///< Largest jerk, mm/s^3 (> 0, S_CURVE only)
+
+    /**
+     * @brief Length of the ramp in seconds
+     */
+    double duration() const;
+
+    /**
+     * @brief Speed (mm/s, rounded) at a time since the ramp started; toSpeed once finished
+     */
+    int speedAt(double seconds) const;
+};
+
+/**
+ * @class SpeedRamp
+ * @brief Handle of one running ramp
+ *
+ * The engine thread publishes the setpoint; the owner reads it with
+ * speed() from its own thread, or computes the exact value for the
+ * current time with speedNow(). cancel() stops the ramp at its current
+ * setpoint on the next tick at the latest.
+ */
+class SpeedRamp {
+public:
+    /**
+     * @param clock Time source of the ramp (null: steady clock); must outlive the ramp
+     */
+    SpeedRamp(const RampPlan& plan, std::function<void(int)> onTick, const MachineClock* clock = nullptr);
+
+    SpeedRamp(const SpeedRamp&) = delete;
+    SpeedRamp& operator=(const SpeedRamp&) = delete;
+
+    /**
+     * @brief Current setpoint in mm/s
+     */
+    int speed() const { return setpoint.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Seconds since the ramp started, on its time source
+     */
+    double elapsedSeconds() const;
+
+    /**
+     * @brief Setpoint for this instant (toSpeed once elapsedSeconds() reaches duration())
+     */
+    int speedNow() const { return rampPlan.speedAt(elapsedSeconds()); }
+
+    double duration() const { return durationSeconds; }
+
+    /**
+     * @brief true once the target speed was reached
+     */
+    bool isDone() const { return done.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Stops the ramp at its current setpoint
+     */
+    void cancel() { cancelled.store(true, std::memory_order_release); }
+
+    const RampPlan& plan() const { return rampPlan; }
+
+private:
+    friend class RampEngine;
+
+    /**
+     * @brief Publishes the setpoint for the current time
+     * @return false once the ramp is finished or cancelled
+     */
+    bool advance();
+
+    /**
+     * @brief Now on the ramp's time source in ns
+     */
+    std::int64_t nowNs() const;
+
+    const RampPlan rampPlan;
+    const double durationSeconds;
+    std::function<void(int)> onTick;    ///< Called on the engine thread with each new setpoint (may be empty)
+    const MachineClock* clock;          ///< Null: steady clock
+    std::int64_t startedNs;
+    std::atomic<int> setpoint;
+    std::atomic<bool> done{false};
+    std::atomic<bool> cancelled{false};
+};
+
+/**
+ * @class RampEngine
+ * @brief Timer thread advancing all active ramps once per tick
+ */
+class RampEngine {
+public:
+    /**
+     * @param tick Control period
+     */
+    explicit RampEngine(std::chrono::milliseconds tick = std::chrono::milliseconds(10));
+    ~RampEngine();
+
+    RampEngine(const RampEngine&) = delete;
+    RampEngine& operator=(const RampEngine&) = delete;
+
+    /**
+     * @brief Registers a ramp; it starts now and is advanced from the next tick
+     * @param onTick Called on the engine thread with each new setpoint (optional)
+     * @param clock Time source of the ramp (null: steady clock); must outlive the ramp
+     */
+    std::shared_ptr<SpeedRamp> start(const RampPlan& plan, std::function<void(int)> onTick = nullptr,
+                                     const MachineClock* clock = nullptr);
+
+    /**
+     * @brief Number of ramps still running
+     */
+    std::size_t active() const;
+
+    /**
+     * @brief Process-wide engine used by machines that are not given one
+     */
+    static RampEngine& shared();
+
+private:
+    void run();
+
+    const std::chrono::milliseconds tick;
+    mutable std::mutex mutex;
+    std::condition_variable wakeup;
+    std::vector<std::shared_ptr<SpeedRamp>> ramps;  ///< Guarded by mutex
+    bool stopping = false;                          ///< Guarded by mutex
+    std::thread worker;
+};
+
+#endif // LABELM_RAMP_H
@@ -0,0 +1,88 @@
+/**
+ * @file labelm_replay.h
+ * @brief Fast replay of the CSV production log
+ *
+ * After a restart the counters of the previous session can be rebuilt
+ * from production_log.txt. The file is memory-mapped and scanned with a
+ * hand-written parser that never allocates, so replay runs at roughly
+ * the speed the file can be read from disk.
+ */
+#ifndef LABELM_REPLAY_H
+#define LABELM_REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "labelm_logger.h"
+#include "labelm_time.h"
+
+/**
+ * @struct CsvLogRow
+ * @brief One parsed `Timestamp,ProductID,Temperature,Speed,Status` row
+ */
+struct CsvLogRow {
+    std::int64_t timestampNs = 0;   ///< Local timestamp converted to ns since the Unix epoch
+    std::int32_t productId = 0;
+    double temperature = 0.0;
+    std::int32_t conveyorSpeed = 0;
+    LogStatus status = LogStatus::SUCCESS;
+};
+
+/**
+ * @brief Parses one CSV log row without allocating
+ *
+ * @param begin First character of the row
+ * @param end One past the last character (newline excluded; a trailing
+ *            '\r' is tolerated)
+ * @param parser Timestamp cache of the calling thread
+ * @param row Receives the fields
+ * @return false if the row is malformed (or the header row)
+ */
+bool parseCsvLogRow(const char* begin, const char* end, TimestampParser& parser, CsvLogRow& row);
+
+/**
+ * @struct ReplaySummary
+ * @brief Machine counters rebuilt from a production log
+ */
+struct ReplaySummary {
+    std::uint64_t rows = 0;             ///< Valid data rows
+    std::uint64_t malformedRows = 0;    ///< Rows that could not be parsed (header excluded)
+    std::uint64_t successRows = 0;
+    std::uint64_t failureRows = 0;
+    std::uint64_t bytes = 0;            ///< Size of the log file (uncompressed)
+    int productsLabeled = 0;            ///< productsLabeled after the last row
+    int errorCount = 0;                 ///< FAILURE rows (one error each)
+    double lastTemperature = 0.0;       ///< Temperature of the last row
+    int lastSpeed = 0;                  ///< Conveyor speed of the last row
+    std::int64_t firstTimestampNs = 0;
+    std::int64_t lastTimestampNs = 0;
+};
+
+/**
+ * @brief Replays a CSV production log
+ *
+ * The file is mapped read-only and rows are located with memchr(). A
+ * partial last row (e.g. from a crash) is counted as malformed.
+ *
+ * @param path CSV production log
+ * @param summary Receives the rebuilt counters
+ * @param error Receives a description if the file cannot be read
+ * @param callback Optional; invoked for every valid row in file order
+ * @return true if the file was read
+ */
+bool replayCsvLog(const std::string& path, ReplaySummary& summary, std::string& error,
+                  const std::function<void(const CsvLogRow&)>& callback = nullptr);
+
+/**
+ * @brief Replays a gzip-compressed CSV log (a compressed rotation segment)
+ *
+ * Same result as replayCsvLog() on the uncompressed file; the data is
+ * streamed through zlib in 64 KiB chunks. Fails with an error when the
+ * library was built without zlib.
+ */
+bool replayCompressedCsvLog(const std::string& path, ReplaySummary& summary, std::string& error,
+                            const std::function<void(const CsvLogRow&)>& callback = nullptr);
+
+#endif // LABELM_REPLAY_H
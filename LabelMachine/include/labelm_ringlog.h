@@ -0,0 +1,100 @@
+/**
+ * @file labelm_ringlog.h
+ * @brief Crash-survivable production log in a memory-mapped ring file
+ *
+ * The file is a RingLogHeader followed by `capacity` JournalRecord slots.
+ * Writing a record is a handful of plain memory stores into the shared
+ * mapping; the kernel writes dirty pages back on its own schedule, so a
+ * crash of the controller process loses nothing that was already stored.
+ * (A power loss can still lose pages that were not yet written back.)
+ * The newest `capacity` records stay recoverable with `labelm-export`.
+ */
+#ifndef LABELM_RINGLOG_H
+#define LABELM_RINGLOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "labelm_journal.h"
+
+/**
+ * @struct RingLogHeader
+ * @brief First 64 bytes of a ring log file
+ *
+ * Sequence numbers count records since the file was created. Records with
+ * tail <= seq < head are valid and live in slot `seq % capacity`.
+ */
+struct RingLogHeader {
+    char magic[4];                      ///< "LMR1"
+    std::uint16_t version;              ///< Format version (RING_LOG_VERSION)
+    std::uint16_t recordSize;           ///< sizeof(JournalRecord)
+    std::uint64_t capacity;             ///< Number of record slots
+    std::atomic<std::uint64_t> head;    ///< Sequence number of the next record to write
+    std::atomic<std::uint64_t> tail;    ///< Sequence number of the oldest valid record
+    std::uint8_t reserved[32];          ///< Zero
+};
+
+static_assert(sizeof(RingLogHeader) == 64, "ring log header must stay 64 bytes");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "ring log sequence numbers must be lock-free to live in a shared mapping");
+
+constexpr char RING_LOG_MAGIC[4] = {'L', 'M', 'R', '1'};
+constexpr std::uint16_t RING_LOG_VERSION = 1;
+
+/**
+ * @class MappedRingLogSink
+ * @brief LogSink that stores records in a memory-mapped ring file
+ *
+ * An existing ring file with the same capacity is reopened and appended
+ * to, so history survives restarts; otherwise the file is (re)created.
+ * write() performs no system calls and is cheap enough to be called
+ * directly from the labeling path without a logger thread.
+ */
+class MappedRingLogSink : public LogSink {
+public:
+    /**
+     * @param path Ring file
+     * @param capacity Number of records kept (older ones are overwritten)
+     */
+    MappedRingLogSink(const std::string& path, std::size_t capacity);
+    ~MappedRingLogSink() override;
+
+    MappedRingLogSink(const MappedRingLogSink&) = delete;
+    MappedRingLogSink& operator=(const MappedRingLogSink&) = delete;
+
+    bool isOpen() const override;
+    void write(const LogRecord& record) override;
+
+    /**
+     * @brief Schedules write-back of dirty pages (msync with MS_ASYNC)
+     */
+    void flush() override;
+
+    LogWriterStats stats() const override;
+
+private:
+    RingLogHeader* header = nullptr;    ///< Start of the mapping
+    JournalRecord* slots = nullptr;     ///< Record slots following the header
+    std::size_t mappedBytes = 0;        ///< Size of the mapping
+    std::uint64_t written = 0;          ///< Records written by this instance
+};
+
+/**
+ * @brief Reads the valid records of a ring log file, oldest first
+ *
+ * Safe to run against a file that is still being written: records that
+ * are overwritten while being copied are skipped.
+ *
+ * @param path Ring file
+ * @param callback Invoked for each record in sequence order
+ * @param error Receives a description if the file cannot be read
+ * @return true on success
+ */
+bool readRingLog(const std::string& path,
+                 const std::function<void(const LogRecord&)>& callback,
+                 std::string& error);
+
+#endif // LABELM_RINGLOG_H
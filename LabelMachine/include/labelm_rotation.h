@@ -0,0 +1,112 @@
+/**
+ * @file labelm_rotation.h
+ * @brief Size/time based rotation of the CSV production log
+ *
+ * Instead of one ever-growing file that is truncated on every restart,
+ * the log is written as numbered segments next to the configured path:
+ * `production_log.txt` becomes `production_log-000001.txt`,
+ * `production_log-000002.txt`, ... A new session continues after the
+ * highest existing number, so restarts keep history.
+ *
+ * The next segment is created ahead of time by a housekeeping thread.
+ * Rotating is a pointer swap on the logger thread; closing the old
+ * segment, retention and optional gzip compression happen in the
+ * background, and none of it runs on the labeling path.
+ */
+#ifndef LABELM_ROTATION_H
+#define LABELM_ROTATION_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "labelm_logger.h"
+
+/**
+ * @struct LogSegment
+ * @brief One rotated log segment found on disk
+ */
+struct LogSegment {
+    std::uint64_t number;       ///< Segment number (1, 2, ...)
+    std::string path;           ///< File path
+    bool compressed;            ///< `.gz` segment
+};
+
+/**
+ * @brief Path of segment `number` of a rotated log (`<stem>-NNNNNN<ext>`)
+ */
+std::string logSegmentPath(const std::string& basePath, std::uint64_t number);
+
+/**
+ * @brief Lists the segments of a rotated log, oldest first
+ */
+std::vector<LogSegment> listLogSegments(const std::string& basePath);
+
+/**
+ * @class RotatingCsvLogSink
+ * @brief CsvLogSink that rolls over to a new segment by size or log time
+ *
+ * Each segment is a complete CSV log with its own header and sidecar
+ * index. Segment age is measured with record timestamps, so rotation
+ * follows simulated time as well.
+ *
+ * Thread Safety: like CsvLogSink, write()/flush() from one thread (the
+ * logger thread behind AsyncLogWriter).
+ */
+class RotatingCsvLogSink : public LogSink {
+public:
+    /**
+     * @param basePath Configured log path; segments are derived from it
+     * @param rotation Limits, retention and compression
+     * @param indexInterval Rows between index entries per segment (0: none)
+     */
+    RotatingCsvLogSink(const std::string& basePath, const LogRotationOptions& rotation, std::size_t indexInterval);
+    ~RotatingCsvLogSink() override;
+
+    RotatingCsvLogSink(const RotatingCsvLogSink&) = delete;
+    RotatingCsvLogSink& operator=(const RotatingCsvLogSink&) = delete;
+
+    bool isOpen() const override;
+    void write(const LogRecord& record) override;
+    void flush() override;
+    LogWriterStats stats() const override;
+
+private:
+    std::unique_ptr<CsvLogSink> openSegment(std::uint64_t number) const;
+    void rotate(std::int64_t timestampNs);
+    void housekeeping();
+    void pruneSegments(std::uint64_t activeNumber);
+
+    std::string basePath;
+    LogRotationOptions rotation;
+    std::size_t indexInterval;
+
+    // Logger thread
+    std::unique_ptr<CsvLogSink> active;
+    std::uint64_t activeNumber = 0;
+    std::int64_t segmentStartNs = 0;
+    bool segmentStarted = false;        ///< segmentStartNs holds the first record's time
+    std::uint64_t writtenBefore = 0;    ///< Rows in closed segments
+
+    // Shared with the housekeeping thread (guarded by mutex)
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable opened;     ///< Signalled when a claimed segment has been opened
+    std::unique_ptr<CsvLogSink> next;   ///< Pre-created segment activeNumber + 1
+    std::uint64_t claimed = 0;          ///< Segment being opened by either thread (0: none); never opened twice
+    std::uint64_t nextNumber = 0;       ///< Segment the housekeeper should pre-create (0: none)
+    std::vector<std::unique_ptr<CsvLogSink>> retired;   ///< Segments to close
+    std::vector<std::uint64_t> closedNumbers;           ///< Closed segments to compress
+    std::uint64_t pruneBelow = 0;       ///< Apply retention to segments below this number
+    bool stopping = false;
+
+    std::thread worker;                 ///< Housekeeping thread (started last)
+};
+
+#endif // LABELM_ROTATION_H
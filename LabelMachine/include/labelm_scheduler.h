@@ -0,0 +1,124 @@
+/**
+ * @file labelm_scheduler.h
+ * @brief Discrete-event production simulation on a virtual clock
+ *
+ * Instead of sleeping between products, a simulation schedules timed
+ * events (product arrivals, pauses, roll changes, ...) in a priority
+ * queue. run() pops them in time order, jumps the SimulationClock to each
+ * event's time and applies it to the machine, so a full shift runs in
+ * milliseconds while logs and events carry simulated timestamps.
+ */
+#ifndef LABELM_SCHEDULER_H
+#define LABELM_SCHEDULER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "labelm_time.h"
+
+class LabelingMachine;
+
+/**
+ * @enum ScheduledEventType
+ * @brief What happens to the machine when a scheduled event fires
+ */
+enum class ScheduledEventType : std::uint8_t {
+    PRODUCT_ARRIVAL,    ///< detectProduct(true)
+    PRODUCT_EXIT,       ///< detectProduct(false)
+    START,              ///< start()
+    STOP,               ///< stop()
+    PAUSE,              ///< pause()
+    RESUME,             ///< resume()
+    ROLL_CHANGE,        ///< loadLabelRoll(value)
+    SET_SPEED,          ///< setSpeed(value)
+    CALLBACK            ///< Invoke the event's callback
+};
+
+/**
+ * @struct ScheduledEvent
+ * @brief One timed event
+ */
+struct ScheduledEvent {
+    std::int64_t timeNs;                            ///< Simulated time (ns since the Unix epoch)
+    std::uint64_t sequence;                         ///< Insertion order, breaks ties (FIFO)
+    ScheduledEventType type;
+    std::int32_t value;                             ///< Argument for ROLL_CHANGE / SET_SPEED
+    std::function<void(LabelingMachine&)> callback; ///< CALLBACK only
+};
+
+/**
+ * @class EventScheduler
+ * @brief Priority queue of timed events driving a machine on a SimulationClock
+ *
+ * Events at the same time fire in the order they were scheduled. Events
+ * scheduled in the past fire immediately (at the current clock time).
+ * Callbacks may schedule further events.
+ */
+class EventScheduler {
+public:
+    /**
+     * @param clock Simulation clock advanced by run(); the machine should
+     *              use the same clock (LabelingMachine::setClock)
+     */
+    explicit EventScheduler(SimulationClock& clock);
+
+    /**
+     * @brief Schedules an event at an absolute simulated time
+     */
+    void scheduleAt(std::int64_t timeNs, ScheduledEventType type, std::int32_t value = 0);
+
+    /**
+     * @brief Schedules an event relative to the current simulated time
+     */
+    void scheduleAfter(std::chrono::nanoseconds delay, ScheduledEventType type, std::int32_t value = 0);
+
+    /**
+     * @brief Schedules an arbitrary action at an absolute simulated time
+     */
+    void scheduleCallback(std::int64_t timeNs, std::function<void(LabelingMachine&)> callback);
+
+    /**
+     * @brief Schedules a stream of products (arrival followed by exit)
+     *
+     * @param firstArrivalNs Time of the first arrival
+     * @param count Number of products
+     * @param interval Time between consecutive arrivals
+     * @param dwell Time a product stays in the labeling position
+     */
+    void scheduleProducts(std::int64_t firstArrivalNs, std::size_t count,
+                          std::chrono::nanoseconds interval, std::chrono::nanoseconds dwell);
+
+    /**
+     * @brief Runs all events up to and including endNs, then moves the clock to endNs
+     * @return Number of events executed
+     */
+    std::size_t runUntil(LabelingMachine& machine, std::int64_t endNs);
+
+    /**
+     * @brief Runs until no events are left
+     * @return Number of events executed
+     */
+    std::size_t runAll(LabelingMachine& machine);
+
+    std::size_t pending() const { return queue.size(); }
+    SimulationClock& getClock() { return clock; }
+
+private:
+    struct Later {
+        bool operator()(const ScheduledEvent& a, const ScheduledEvent& b) const {
+            return a.timeNs != b.timeNs ? a.timeNs > b.timeNs : a.sequence > b.sequence;
+        }
+    };
+
+    void execute(LabelingMachine& machine, const ScheduledEvent& event);
+
+    SimulationClock& clock;
+    std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, Later> queue;
+    std::uint64_t nextSequence = 0;
+};
+
+#endif // LABELM_SCHEDULER_H
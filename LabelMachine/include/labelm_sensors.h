@@ -0,0 +1,214 @@
+/**
+ * @file labelm_sensors.h
+ * @brief Lock-free sensor ingestion modeled on interrupt delivery
+ *
+ * On the real machine the photoelectric and temperature sensors raise
+ * interrupts. An interrupt handler must never wait for the control logic,
+ * so it only records what happened and when. This module reproduces that
+ * split: each producer thread (a simulated ISR) owns a wait-free SPSC ring
+ * of timestamped SensorDelta records, and a single control thread drains
+ * all rings in batches and applies them to the LabelingMachine. Sensor
+ * bursts therefore never block on logging or console I/O, and the time
+ * from capture to applied label can be measured.
+ */
+#ifndef LABELM_SENSORS_H
+#define LABELM_SENSORS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "labelm_spsc.h"
+
+class LabelingMachine;
+
+/**
+ * @enum SensorDeltaType
+ * @brief Which sensor input changed
+ */
+enum class SensorDeltaType : std::uint8_t {
+    PRODUCT_DETECTED,   ///< Photoelectric sensor: product entered labeling position
+    PRODUCT_CLEARED,    ///< Photoelectric sensor: product left labeling position
+    TEMPERATURE         ///< New temperature reading in `value` (°C)
+};
+
+/**
+ * @struct SensorDelta
+ * @brief One sensor change as captured by the interrupt handler
+ */
+struct SensorDelta {
+    std::int64_t captureNs;     ///< monotonicTimeNs() at capture (latency reference)
+    double value;               ///< TEMPERATURE reading, unused otherwise
+    SensorDeltaType type;
+};
+
+/**
+ * @struct SensorIngestionOptions
+ * @brief Ring and control-thread tuning of a SensorIngestion
+ */
+struct SensorIngestionOptions {
+    std::size_t producerCount = 1;          ///< Number of producer rings (one per ISR thread)
+    std::size_t ringCapacity = 1024;        ///< Deltas buffered per producer
+    std::size_t batchSize = 64;             ///< Max deltas taken from each ring per drain pass
+    std::chrono::microseconds idleWait{50}; ///< Control thread sleep when all rings are empty
+};
+
+/**
+ * @struct SensorIngestionStats
+ * @brief Counters and capture-to-label latency of a SensorIngestion
+ */
+struct SensorIngestionStats {
+    /// Latency buckets: bucket i counts latencies in [2^i, 2^(i+1)) ns
+    static constexpr std::size_t LATENCY_BUCKETS = 40;
+
+    std::uint64_t received = 0;     ///< Deltas pushed by producers
+    std::uint64_t dropped = 0;      ///< Deltas lost because a ring was full
+    std::uint64_t applied = 0;      ///< Deltas applied to the machine
+    std::uint64_t batches = 0;      ///< Drain passes that applied at least one delta
+    std::uint64_t maxBatch = 0;     ///< Largest number of deltas applied in one pass
+    std::uint64_t labeled = 0;      ///< PRODUCT_DETECTED deltas that produced a label
+    std::uint64_t latencyTotalNs = 0;
+    std::uint64_t latencyMaxNs = 0;
+    std::array<std::uint64_t, LATENCY_BUCKETS> latencyBuckets{};
+
+    /**
+     * @brief Mean capture-to-label latency
+     */
+    double meanLatencyNs() const {
+        return labeled > 0 ? static_cast<double>(latencyTotalNs) / labeled : 0.0;
+    }
+
+    /**
+     * @brief Upper bound of the bucket holding the given latency percentile
+     * @param fraction Percentile as a fraction (0.99 for p99)
+     */
+    std::uint64_t latencyPercentileNs(double fraction) const;
+};
+
+/**
+ * @class SensorProducer
+ * @brief Push side of one sensor ring, owned by exactly one producer thread
+ *
+ * push() is wait-free: it copies the delta into the ring or, if the ring
+ * is full, counts a drop and returns. It never blocks and never allocates,
+ * which is what an interrupt handler needs.
+ */
+class SensorProducer {
+public:
+    explicit SensorProducer(std::size_t capacity) : ring(capacity) {}
+
+    SensorProducer(const SensorProducer&) = delete;
+    SensorProducer& operator=(const SensorProducer&) = delete;
+
+    /**
+     * @brief Queues a delta for the control thread
+     * @return false if the ring was full and the delta was dropped
+     */
+    bool push(const SensorDelta& delta);
+
+    /**
+     * @brief Captures a photoelectric sensor edge, stamped now
+     */
+    bool productDetected(bool detected);
+
+    /**
+     * @brief Captures a temperature reading, stamped now
+     */
+    bool temperature(double celsius);
+
+private:
+    friend class SensorIngestion;
+
+    SpscRing<SensorDelta> ring;
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<std::uint64_t> dropped{0};
+};
+
+/**
+ * @class SensorIngestion
+ * @brief Drains producer rings in batches and applies them to one machine
+ *
+ * Each drain pass takes up to batchSize deltas from every ring, orders the
+ * batch by capture time and applies it: product edges go to
+ * LabelingMachine::detectProduct(), readings to
+ * LabelingMachine::updateTemperature(). For every product edge that
+ * results in a label, the time from capture until applyLabel() returned
+ * is recorded.
+ *
+ * The machine is driven either by the internal control thread (start() /
+ * stop()) or by calling drain() from the thread that owns the machine.
+ *
+ * Thread Safety: each SensorProducer is used by one thread. While the
+ * control thread runs it owns the machine; no other thread may call into
+ * the machine until stop() returns. stats() may be called from any thread.
+ */
+class SensorIngestion {
+public:
+    /**
+     * @param machine Machine to drive; must outlive the ingestion
+     * @param options Ring sizes, batch size and idle behaviour
+     */
+    SensorIngestion(LabelingMachine& machine, const SensorIngestionOptions& options = SensorIngestionOptions());
+    ~SensorIngestion();
+
+    SensorIngestion(const SensorIngestion&) = delete;
+    SensorIngestion& operator=(const SensorIngestion&) = delete;
+
+    /**
+     * @brief Gets the ring of producer `index` (0 .. producerCount - 1)
+     */
+    SensorProducer& producer(std::size_t index) { return *producers[index]; }
+    std::size_t producerCount() const { return producers.size(); }
+
+    /**
+     * @brief Starts the control thread
+     * @return false if it is already running
+     */
+    bool start();
+
+    /**
+     * @brief Applies everything still queued and joins the control thread
+     */
+    void stop();
+
+    /**
+     * @brief Runs one drain pass on the calling thread
+     *
+     * For single-threaded use (no control thread); the caller must own the
+     * machine.
+     *
+     * @return Number of deltas applied
+     */
+    std::size_t drain();
+
+    SensorIngestionStats stats() const;
+
+private:
+    void run();
+    void apply(const SensorDelta& delta);
+
+    LabelingMachine& machine;
+    SensorIngestionOptions options;
+    std::vector<std::unique_ptr<SensorProducer>> producers;
+    std::vector<SensorDelta> batch;         ///< Reused drain buffer (control thread)
+
+    // Written by the control thread only; relaxed atomics so stats() can
+    // read them while it runs
+    std::atomic<std::uint64_t> applied{0};
+    std::atomic<std::uint64_t> batches{0};
+    std::atomic<std::uint64_t> maxBatch{0};
+    std::atomic<std::uint64_t> labeled{0};
+    std::atomic<std::uint64_t> latencyTotalNs{0};
+    std::atomic<std::uint64_t> latencyMaxNs{0};
+    std::array<std::atomic<std::uint64_t>, SensorIngestionStats::LATENCY_BUCKETS> latencyBuckets{};
+
+    std::atomic<bool> stopping{false};
+    std::thread worker;                     ///< Control thread
+};
+
+#endif // LABELM_SENSORS_H
@@ -0,0 +1,105 @@
+/**
+ * @file labelm_spsc.h
+ * @brief Bounded single-producer/single-consumer ring buffer
+ *
+ * Used wherever one thread hands fixed-size records to exactly one other
+ * thread (production logger, sensor ingestion, fleet routing). Both push
+ * and pop are wait-free: no locks, no allocation, no system calls.
+ */
+#ifndef LABELM_SPSC_H
+#define LABELM_SPSC_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @class SpscRing
+ * @brief Wait-free bounded queue for one producer and one consumer thread
+ *
+ * The capacity is rounded up to the next power of two so the slot index
+ * is a simple mask. T must be trivially copyable in practice; records are
+ * copied in and out by value.
+ *
+ * Thread Safety: exactly one thread may call tryPush() and exactly one
+ * (other) thread may call tryPop(). size() may be called from either.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : mask(roundUpPowerOfTwo(capacity) - 1)
+        , slots(new T[mask + 1])
+    {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Appends a record if there is room
+     * @param item Record to copy into the ring
+     * @return true if queued, false if the ring is full
+     */
+    bool tryPush(const T& item) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - cachedTail > mask) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h - cachedTail > mask) {
+                return false;
+            }
+        }
+        slots[h & mask] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest record if one is available
+     * @param item Receives the record
+     * @return true if a record was popped, false if the ring is empty
+     */
+    bool tryPop(T& item) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t == cachedHead) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t == cachedHead) {
+                return false;
+            }
+        }
+        item = slots[t & mask];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of queued records
+     */
+    std::size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    static std::size_t roundUpPowerOfTwo(std::size_t value) {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<T[]> slots;
+
+    // Producer and consumer indices live on separate cache lines so the two
+    // threads do not false-share. Each side caches the other's index and
+    // only re-reads it when the ring looks full/empty.
+    alignas(64) std::atomic<std::size_t> head{0};   ///< Next slot to write (producer)
+    std::size_t cachedTail = 0;                     ///< Producer's view of tail
+    alignas(64) std::atomic<std::size_t> tail{0};   ///< Next slot to read (consumer)
+    std::size_t cachedHead = 0;                     ///< Consumer's view of head
+};
+
+#endif // LABELM_SPSC_H
@@ -0,0 +1,221 @@
+/**
+ * @file labelm_statemachine.h
+ * @brief Compile-time state transition table of the LM-3000
+ *
+ * Every state change of LabelingMachine is the result of a StateEvent
+ * looked up in STATE_TRANSITIONS[state][event]. The table is constexpr,
+ * so a lookup is a single indexed load, and the safety rules below are
+ * checked by static_assert: a table edit that introduces an illegal
+ * transition does not compile.
+ */
+#ifndef LABELM_STATEMACHINE_H
+#define LABELM_STATEMACHINE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "labelm_types.h"
+
+/**
+ * @enum StateEvent
+ * @brief Requests and conditions that may change the machine state
+ */
+enum class StateEvent : std::uint8_t {
+    START,              ///< start(): begin production
+    STOP,               ///< stop(): emergency/normal stop, legal everywhere
+    PAUSE,              ///< pause()
+    RESUME,             ///< resume()
+    ENTER_MAINTENANCE,  ///< enterMaintenance()
+    EXIT_MAINTENANCE,   ///< exitMaintenance()
+    LABEL,              ///< applyLabel(): only while labeling, never changes state
+    SET_SPEED,          ///< setSpeed(): only while labeling, never changes state
+    LABELS_LOW,         ///< Roll dropped below lowLabelThreshold
+    LABELS_RESTORED,    ///< Roll reloaded above lowLabelThreshold
+    FAULT,              ///< Safety check failed (temperature, empty roll)
+    CLEAR_FAULT,        ///< Cause of the fault removed (roll reloaded)
+    COUNT
+};
+
+constexpr std::size_t MACHINE_STATE_COUNT = static_cast<std::size_t>(MachineState::MAINTENANCE) + 1;
+constexpr std::size_t STATE_EVENT_COUNT = static_cast<std::size_t>(StateEvent::COUNT);
+
+/**
+ * @struct StateTransition
+ * @brief One cell of the transition table
+ */
+struct StateTransition {
+    bool legal;             ///< Event is accepted in this state
+    MachineState target;    ///< State after the event (only if legal)
+};
+
+namespace statemachine_detail {
+
+constexpr StateTransition REJECT = {false, MachineState::IDLE};
+
+constexpr StateTransition to(MachineState target) {
+    return {true, target};
+}
+
+constexpr std::size_t index(MachineState state) { return static_cast<std::size_t>(state); }
+constexpr std::size_t index(StateEvent event) { return static_cast<std::size_t>(event); }
+
+} // namespace statemachine_detail
+
+using StateTransitionTable = std::array<std::array<StateTransition, STATE_EVENT_COUNT>, MACHINE_STATE_COUNT>;
+
+/**
+ * @brief The transition table: rows are MachineState, columns StateEvent
+ */
+constexpr StateTransitionTable STATE_TRANSITIONS = [] {
+    using namespace statemachine_detail;
+    constexpr MachineState IDLE = MachineState::IDLE;
+    constexpr MachineState RUNNING = MachineState::RUNNING;
+    constexpr MachineState LOW_LABEL = MachineState::LOW_LABEL;
+    constexpr MachineState PAUSED = MachineState::PAUSED;
+    constexpr MachineState ERROR = MachineState::ERROR;
+    constexpr MachineState MAINTENANCE = MachineState::MAINTENANCE;
+    const StateTransition X = REJECT;
+
+    //               START        STOP      PAUSE        RESUME       ENTER_MAINT      EXIT_MAINT LABEL          SET_SPEED      LABELS_LOW     LABELS_RESTORED FAULT      CLEAR_FAULT
+    return StateTransitionTable{{
+        /* IDLE */        {{to(RUNNING), to(IDLE), X,           X,           to(MAINTENANCE), X,         X,             X,             X,             X,              to(ERROR), X}},
+        /* RUNNING */     {{X,           to(IDLE), to(PAUSED),  X,           X,               X,         to(RUNNING),   to(RUNNING),   to(LOW_LABEL), X,              to(ERROR), X}},
+        /* LOW_LABEL */   {{X,           to(IDLE), to(PAUSED),  X,           X,               X,         to(LOW_LABEL), to(LOW_LABEL), to(LOW_LABEL), to(RUNNING),    to(ERROR), X}},
+        /* PAUSED */      {{X,           to(IDLE), X,           to(RUNNING), X,               X,         X,             X,             X,             X,              to(ERROR), X}},
+        /* ERROR */       {{X,           to(IDLE), X,           X,           X,               X,         X,             X,             X,             X,              to(ERROR), to(IDLE)}},
+        /* MAINTENANCE */ {{X,           to(IDLE), X,           X,           X,               to(IDLE),  X,             X,             X,             X,              X,         X}},
+    }};
+}();
+
+/**
+ * @brief Looks up the transition for an event in a state
+ */
+constexpr StateTransition lookupTransition(MachineState state, StateEvent event) {
+    return STATE_TRANSITIONS[statemachine_detail::index(state)][statemachine_detail::index(event)];
+}
+
+/**
+ * @brief Whether the event is accepted in the given state
+ */
+constexpr bool isTransitionLegal(MachineState state, StateEvent event) {
+    return lookupTransition(state, event).legal;
+}
+
+/**
+ * @brief Whether the state is one in which products are labeled
+ */
+constexpr bool isLabelingState(MachineState state) {
+    return state == MachineState::RUNNING || state == MachineState::LOW_LABEL;
+}
+
+namespace statemachine_detail {
+
+/// Whether any single event leads from `from` to `to`
+constexpr bool anyEventLeads(MachineState from, MachineState to) {
+    for (std::size_t e = 0; e < STATE_EVENT_COUNT; e++) {
+        const StateTransition t = STATE_TRANSITIONS[index(from)][e];
+        if (t.legal && t.target == to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// STOP must be accepted everywhere and always end in IDLE
+constexpr bool stopAlwaysReachesIdle() {
+    for (std::size_t s = 0; s < MACHINE_STATE_COUNT; s++) {
+        const StateTransition t = STATE_TRANSITIONS[s][index(StateEvent::STOP)];
+        if (!t.legal || t.target != MachineState::IDLE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Labeling states are entered only by START from IDLE, RESUME from PAUSED
+/// or the low-label events between RUNNING and LOW_LABEL
+constexpr bool labelingEnteredOnlyByDesign() {
+    for (std::size_t s = 0; s < MACHINE_STATE_COUNT; s++) {
+        for (std::size_t e = 0; e < STATE_EVENT_COUNT; e++) {
+            const StateTransition t = STATE_TRANSITIONS[s][e];
+            if (!t.legal || !isLabelingState(t.target) || isLabelingState(static_cast<MachineState>(s))) {
+                continue;
+            }
+            const bool started = s == index(MachineState::IDLE) && e == index(StateEvent::START);
+            const bool resumed = s == index(MachineState::PAUSED) && e == index(StateEvent::RESUME);
+            if (!started && !resumed) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// The given event, where legal, never changes the state
+constexpr bool neverChangesState(StateEvent event) {
+    for (std::size_t s = 0; s < MACHINE_STATE_COUNT; s++) {
+        const StateTransition t = STATE_TRANSITIONS[s][index(event)];
+        if (t.legal && index(t.target) != s) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// No event other than the given one leads into `target` from another state
+constexpr bool onlyEventEnters(StateEvent event, MachineState target) {
+    for (std::size_t s = 0; s < MACHINE_STATE_COUNT; s++) {
+        for (std::size_t e = 0; e < STATE_EVENT_COUNT; e++) {
+            const StateTransition t = STATE_TRANSITIONS[s][e];
+            if (t.legal && t.target == target && s != index(target) && e != index(event)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Every state can be reached from IDLE
+constexpr bool allStatesReachable() {
+    bool reached[MACHINE_STATE_COUNT] = {};
+    reached[index(MachineState::IDLE)] = true;
+    for (std::size_t round = 0; round < MACHINE_STATE_COUNT; round++) {
+        for (std::size_t s = 0; s < MACHINE_STATE_COUNT; s++) {
+            for (std::size_t e = 0; reached[s] && e < STATE_EVENT_COUNT; e++) {
+                const StateTransition t = STATE_TRANSITIONS[s][e];
+                if (t.legal) {
+                    reached[index(t.target)] = true;
+                }
+            }
+        }
+    }
+    for (bool r : reached) {
+        if (!r) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace statemachine_detail
+
+static_assert(statemachine_detail::stopAlwaysReachesIdle(),
+              "STOP must be legal in every state and lead to IDLE");
+static_assert(statemachine_detail::labelingEnteredOnlyByDesign(),
+              "Labeling may only start via START from IDLE or RESUME from PAUSED");
+static_assert(!statemachine_detail::anyEventLeads(MachineState::ERROR, MachineState::RUNNING)
+              && !statemachine_detail::anyEventLeads(MachineState::ERROR, MachineState::LOW_LABEL),
+              "An ERROR must be cleared to IDLE before production restarts");
+static_assert(!statemachine_detail::anyEventLeads(MachineState::MAINTENANCE, MachineState::RUNNING)
+              && !statemachine_detail::anyEventLeads(MachineState::MAINTENANCE, MachineState::LOW_LABEL),
+              "Maintenance must be left to IDLE before production restarts");
+static_assert(statemachine_detail::onlyEventEnters(StateEvent::FAULT, MachineState::ERROR),
+              "Only FAULT may lead into ERROR");
+static_assert(statemachine_detail::neverChangesState(StateEvent::LABEL)
+              && statemachine_detail::neverChangesState(StateEvent::SET_SPEED),
+              "LABEL and SET_SPEED must not change the state");
+static_assert(statemachine_detail::allStatesReachable(),
+              "Every state must be reachable from IDLE");
+
+#endif // LABELM_STATEMACHINE_H
@@ -0,0 +1,94 @@
+/**
+ * @file labelm_stats.h
+ * @brief Incremental production statistics with per-state time accounting
+ *
+ * ProductionStats is fed by the machine on every state transition and
+ * every label attempt. It only keeps running totals plus the start time
+ * of the current state, so a snapshot costs the same after one minute or
+ * one month of production and never needs the production log.
+ */
+#ifndef LABELM_STATS_H
+#define LABELM_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "labelm_statemachine.h"
+#include "labelm_types.h"
+
+/**
+ * @struct ProductionStatistics
+ * @brief Snapshot returned by LabelingMachine::getStatistics()
+ */
+struct ProductionStatistics {
+    std::int64_t sessionStartNs = 0;                            ///< Start of the statistics session
+    std::int64_t sessionNs = 0;                                 ///< Time since sessionStartNs
+    std::array<std::int64_t, MACHINE_STATE_COUNT> timeInStateNs{}; ///< Indexed by MachineState
+    std::uint64_t labelsApplied = 0;                            ///< Successful label applications
+    std::uint64_t labelFailures = 0;                            ///< Label attempts on an empty roll
+    std::uint64_t transitions = 0;                              ///< State changes in the session
+    double labelsPerMinute = 0.0;       ///< Labels per minute of labeling time (RUNNING + LOW_LABEL)
+    double efficiency = 0.0;            ///< Labeling time / (labeling + PAUSED + ERROR time), 0..1
+    double successRate = 0.0;           ///< labelsApplied / all label attempts, 0..1
+
+    /**
+     * @brief Time spent in a state during the session
+     */
+    std::int64_t timeIn(MachineState state) const {
+        return timeInStateNs[static_cast<std::size_t>(state)];
+    }
+};
+
+/**
+ * @class ProductionStats
+ * @brief O(1) running totals of one machine's production session
+ *
+ * Every update and every snapshot is constant time: the time of the
+ * current state is accumulated on leaving it, and snapshot() adds the
+ * still-open interval of the current state on the fly.
+ *
+ * Thread Safety: NOT thread-safe; owned by the machine's control thread.
+ */
+class ProductionStats {
+public:
+    /**
+     * @brief Starts a new session
+     * @param nowNs Session start time
+     * @param state Machine state at session start
+     */
+    void reset(std::int64_t nowNs, MachineState state);
+
+    /**
+     * @brief Accounts the time of the state being left
+     */
+    void onTransition(MachineState from, MachineState to, std::int64_t nowNs);
+
+    /**
+     * @brief Counts a label attempt
+     * @param success true if a label was applied, false if the roll was empty
+     */
+    void onLabel(bool success) {
+        if (success) {
+            labelsApplied++;
+        } else {
+            labelFailures++;
+        }
+    }
+
+    /**
+     * @brief Builds the statistics as of nowNs
+     */
+    ProductionStatistics snapshot(std::int64_t nowNs) const;
+
+private:
+    std::int64_t sessionStartNs = 0;
+    std::int64_t stateSinceNs = 0;          ///< Entry time of currentState
+    MachineState currentState = MachineState::IDLE;
+    std::array<std::int64_t, MACHINE_STATE_COUNT> closedStateNs{}; ///< Time of finished intervals
+    std::uint64_t labelsApplied = 0;
+    std::uint64_t labelFailures = 0;
+    std::uint64_t transitions = 0;
+};
+
+#endif // LABELM_STATS_H
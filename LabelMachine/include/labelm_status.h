@@ -0,0 +1,149 @@
+/**
+ * @file labelm_status.h
+ * @brief Live machine status in POSIX shared memory for HMI/monitoring readers
+ *
+ * The machine publishes a MachineStatusSnapshot into a shared-memory
+ * object named statusBlockName(machineId) (`/dev/shm/labelm-status-<id>`)
+ * whenever its state, sensors or counters change. Readers map the block
+ * read-only and copy the snapshot under a sequence lock: the writer never
+ * waits for readers, and a reader that overlaps a write simply retries.
+ * Any number of local processes can poll the block at high frequency
+ * without a system call or any effect on the control loop.
+ *
+ * Block layout: StatusBlockHeader (64 bytes), then the snapshot stored as
+ * 64-bit atomic words so that concurrent copies are well-defined.
+ */
+#ifndef LABELM_STATUS_H
+#define LABELM_STATUS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct MachineStatusSnapshot
+ * @brief Consistent view of one machine, as published in the status block
+ */
+struct MachineStatusSnapshot {
+    std::int64_t updatedNs;             ///< Machine clock at publication (ns since the Unix epoch)
+    std::uint64_t publishCount;         ///< Snapshots published since the block was created
+    std::uint32_t configVersion;        ///< Incremented by every loadConfig()/reloadConfig()
+    std::uint8_t state;                 ///< MachineState
+    std::uint8_t previousState;         ///< MachineState before the last transition
+    std::uint8_t productDetected;       ///< Product sensor (0/1)
+    std::uint8_t reserved;
+    std::int32_t conveyorSpeed;         ///< mm/s
+    std::int32_t labelRollRemaining;
+    std::int32_t productsLabeled;
+    std::int32_t errorCount;
+    double temperature;                 ///< °C
+    char machineId[32];                 ///< NUL-terminated (truncated if longer)
+};
+static_assert(sizeof(MachineStatusSnapshot) % sizeof(std::uint64_t) == 0,
+              "MachineStatusSnapshot is copied as 64-bit words");
+
+constexpr std::size_t STATUS_SNAPSHOT_WORDS = sizeof(MachineStatusSnapshot) / sizeof(std::uint64_t);
+
+/**
+ * @struct StatusBlockHeader
+ * @brief First 64 bytes of a status block
+ *
+ * sequence is odd while the writer updates the snapshot.
+ */
+struct StatusBlockHeader {
+    char magic[4];                      ///< STATUS_BLOCK_MAGIC
+    std::uint16_t version;              ///< STATUS_BLOCK_VERSION
+    std::uint16_t snapshotSize;         ///< sizeof(MachineStatusSnapshot)
+    std::atomic<std::uint32_t> online;  ///< 1 while the publishing machine exists
+    std::uint32_t reserved0;
+    std::atomic<std::uint64_t> sequence; ///< Seqlock counter
+    std::uint8_t reserved[40];          ///< Zero
+};
+static_assert(sizeof(StatusBlockHeader) == 64, "status block header must stay 64 bytes");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+              "status block atomics must be lock-free to live in shared memory");
+
+/**
+ * @struct StatusBlock
+ * @brief Complete shared-memory object
+ */
+struct StatusBlock {
+    StatusBlockHeader header;
+    std::atomic<std::uint64_t> words[STATUS_SNAPSHOT_WORDS];   ///< MachineStatusSnapshot
+};
+
+constexpr char STATUS_BLOCK_MAGIC[4] = {'L', 'M', 'S', '1'};
+constexpr std::uint16_t STATUS_BLOCK_VERSION = 1;
+
+/**
+ * @brief Shared-memory object name of a machine's status block
+ *
+ * `/labelm-status-<machineId>`; characters other than letters, digits,
+ * '-' and '_' are replaced by '_'.
+ */
+std::string statusBlockName(const std::string& machineId);
+
+/**
+ * @class StatusPublisher
+ * @brief Writer side of a status block (one per machine)
+ *
+ * Creates (or takes over) the shared-memory object; the destructor marks
+ * the block offline and removes the name. publish() is a few dozen plain
+ * stores and must only be called from one thread.
+ */
+class StatusPublisher {
+public:
+    explicit StatusPublisher(const std::string& name);
+    ~StatusPublisher();
+
+    StatusPublisher(const StatusPublisher&) = delete;
+    StatusPublisher& operator=(const StatusPublisher&) = delete;
+
+    bool isOpen() const { return block != nullptr; }
+
+    /**
+     * @brief Replaces the published snapshot (publishCount is filled in)
+     */
+    void publish(MachineStatusSnapshot snapshot);
+
+private:
+    std::string name;
+    StatusBlock* block = nullptr;
+    std::uint64_t published = 0;
+};
+
+/**
+ * @class StatusReader
+ * @brief Read-only view of a status block
+ */
+class StatusReader {
+public:
+    explicit StatusReader(const std::string& name);
+    ~StatusReader();
+
+    StatusReader(const StatusReader&) = delete;
+    StatusReader& operator=(const StatusReader&) = delete;
+
+    /**
+     * @brief false if the block does not exist or has an unknown layout
+     */
+    bool isOpen() const { return block != nullptr; }
+
+    /**
+     * @brief true while the publishing machine exists
+     */
+    bool isOnline() const;
+
+    /**
+     * @brief Copies a consistent snapshot
+     * @param maxAttempts Copies tried while writes keep overlapping
+     * @return false if no consistent copy was obtained (writer busy or died mid-write)
+     */
+    bool read(MachineStatusSnapshot& snapshot, int maxAttempts = 1000) const;
+
+private:
+    const StatusBlock* block = nullptr;
+};
+
+#endif // LABELM_STATUS_H
@@ -0,0 +1,170 @@
+/**
+ * @file labelm_time.h
+ * @brief Time sources and timestamp formatting
+ */
+#ifndef LABELM_TIME_H
+#define LABELM_TIME_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class TimestampFormatter
+ * @brief Renders `YYYY-MM-DD HH:MM:SS[.mmm]` local timestamps without allocating
+ *
+ * The date/hour/minute prefix is cached together with the epoch second at
+ * which the cached minute starts. Timestamps inside the cached minute only
+ * re-render the two seconds digits (and optional milliseconds) into the
+ * caller's buffer; localtime_r() is consulted again only when a timestamp
+ * leaves the cached minute.
+ *
+ * Thread Safety: NOT thread-safe. Use one formatter per thread.
+ */
+class TimestampFormatter {
+public:
+    /// Buffer size that always fits a timestamp with milliseconds plus NUL
+    static constexpr std::size_t BUFFER_SIZE = 24;
+
+    /**
+     * @brief Formats a timestamp into a caller-provided buffer
+     *
+     * @param timestampNs Wall-clock time in ns since the Unix epoch
+     * @param buffer Output buffer, NUL-terminated on success
+     * @param size Size of buffer in bytes
+     * @param withMillis Append `.mmm` after the seconds
+     * @return Number of characters written (excluding NUL), 0 if the buffer
+     *         is too small
+     */
+    std::size_t format(std::int64_t timestampNs, char* buffer, std::size_t size, bool withMillis = false);
+
+    /**
+     * @brief Number of localtime_r() calls made so far
+     */
+    std::uint64_t calendarLookups() const { return lookups; }
+
+private:
+    static constexpr std::size_t PREFIX_LENGTH = 17;   ///< "YYYY-MM-DD HH:MM:"
+
+    bool refresh(std::int64_t second);
+
+    std::int64_t minuteStart = 0;       ///< Epoch second of the cached minute's :00
+    bool valid = false;                 ///< prefix/minuteStart hold a cached minute
+    char prefix[PREFIX_LENGTH + 1] = {};
+    std::uint64_t lookups = 0;
+};
+
+/**
+ * @class TimestampParser
+ * @brief Parses `YYYY-MM-DD HH:MM:SS[.mmm]` local timestamps back to epoch time
+ *
+ * Counterpart of TimestampFormatter for reading logs: the epoch second of
+ * the last seen minute prefix is cached, so consecutive log rows from the
+ * same minute need no mktime() call and no allocation.
+ *
+ * Thread Safety: NOT thread-safe. Use one parser per thread.
+ */
+class TimestampParser {
+public:
+    /**
+     * @brief Parses a timestamp
+     *
+     * @param text Start of the timestamp (need not be NUL-terminated)
+     * @param length Characters available: 19, or 23 with milliseconds
+     * @param timestampNs Receives ns since the Unix epoch
+     * @return false if the text is not a valid timestamp
+     */
+    bool parse(const char* text, std::size_t length, std::int64_t& timestampNs);
+
+private:
+    static constexpr std::size_t PREFIX_LENGTH = 17;   ///< "YYYY-MM-DD HH:MM:"
+
+    bool refresh(const char* text);
+
+    std::int64_t minuteStart = 0;       ///< Epoch second of the cached prefix
+    bool valid = false;
+    char prefix[PREFIX_LENGTH] = {};
+};
+
+/**
+ * @brief Current wall-clock time in ns since the Unix epoch
+ */
+std::int64_t systemTimeNs();
+
+/**
+ * @brief Monotonic time in ns (std::chrono::steady_clock), for measuring intervals
+ */
+std::int64_t monotonicTimeNs();
+
+/**
+ * @class MachineClock
+ * @brief Source of wall-clock time for a machine (timestamps, statistics)
+ */
+class MachineClock {
+public:
+    virtual ~MachineClock() = default;
+
+    /**
+     * @brief Current time in ns since the Unix epoch
+     */
+    virtual std::int64_t nowNs() const = 0;
+};
+
+/**
+ * @class SystemClock
+ * @brief MachineClock backed by std::chrono::system_clock
+ */
+class SystemClock : public MachineClock {
+public:
+    std::int64_t nowNs() const override { return systemTimeNs(); }
+
+    /**
+     * @brief Shared instance used by machines without an explicit clock
+     */
+    static const SystemClock& instance();
+};
+
+/**
+ * @class SimulationClock
+ * @brief Virtual clock that only moves when told to
+ *
+ * Lets a simulation run hours of production in milliseconds while every
+ * timestamp (logs, events) still reflects simulated time. Time never
+ * moves backwards: advanceTo() with an earlier time is ignored.
+ *
+ * Thread Safety: nowNs() may be read from any thread; advancing should be
+ * done by one thread (the simulation driver).
+ */
+class SimulationClock : public MachineClock {
+public:
+    /**
+     * @param startNs Initial time (default: the current wall-clock time)
+     */
+    explicit SimulationClock(std::int64_t startNs = systemTimeNs()) : now(startNs) {}
+
+    std::int64_t nowNs() const override { return now.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Moves the clock forward to an absolute time
+     */
+    void advanceTo(std::int64_t timeNs) {
+        if (timeNs > now.load(std::memory_order_relaxed)) {
+            now.store(timeNs, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Moves the clock forward by a duration
+     */
+    void advanceBy(std::chrono::nanoseconds delta) {
+        if (delta.count() > 0) {
+            now.store(now.load(std::memory_order_relaxed) + delta.count(), std::memory_order_release);
+        }
+    }
+
+private:
+    std::atomic<std::int64_t> now;
+};
+
+#endif // LABELM_TIME_H
@@ -0,0 +1,177 @@
+/**
+ * @file labelm_trace.h
+ * @brief Timeline tracing in Chrome trace-event format
+ *
+ * TraceRecorder collects spans (calls such as applyLabel(), log flushes)
+ * and instants (machine events) in one fixed-size buffer per thread. A
+ * buffer has a single writer, so recording is a few stores and one
+ * release store of the buffer size; when a buffer is full further events
+ * of that thread are dropped and counted. Machine state spans (how long
+ * the machine was PAUSED, in MAINTENANCE, ...) go on their own track.
+ *
+ * writeChromeTrace() writes the JSON object format understood by
+ * chrome://tracing and ui.perfetto.dev. Timestamps are steady_clock time
+ * since the recorder was created, independent of the machine clock.
+ *
+ * When tracing is off the recorder pointer is null and TraceSpan costs a
+ * predictable null test.
+ */
+#ifndef LABELM_TRACE_H
+#define LABELM_TRACE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "labelm_events.h"
+
+/**
+ * @struct TraceEvent
+ * @brief One recorded span or instant
+ */
+struct TraceEvent {
+    static constexpr std::size_t TEXT_SIZE = 72;
+
+    std::int64_t startNs;           ///< Since the recorder was created
+    std::int64_t durationNs;        ///< Span length (-1: instant)
+    const char* name;               ///< Static string; null if the name is in text
+    const char* category;           ///< Static string
+    char text[TEXT_SIZE];           ///< Instant message (when name is null)
+};
+
+/**
+ * @class TraceRecorder
+ * @brief Per-thread trace buffers of one machine
+ *
+ * Any thread may record; a thread's buffer is allocated on its first
+ * event (up to MAX_THREADS threads, later threads are not traced).
+ * writeChromeTrace() may run while other threads record: it writes the
+ * events recorded so far.
+ */
+class TraceRecorder {
+public:
+    static constexpr std::size_t MAX_THREADS = 32;
+
+    /**
+     * @param eventsPerThread Capacity of each thread's buffer
+     */
+    explicit TraceRecorder(std::size_t eventsPerThread);
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * @brief Trace time in ns (steady_clock since construction)
+     */
+    std::int64_t nowNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    /**
+     * @brief Records a finished span on the calling thread's track
+     * @param name Static string
+     * @param category Static string
+     */
+    void span(const char* name, const char* category, std::int64_t startNs, std::int64_t endNs);
+
+    /**
+     * @brief Records an instant with a message (copied, truncated to TEXT_SIZE - 1)
+     */
+    void instant(const char* category, const char* text);
+
+    /**
+     * @brief Closes the span of the previous machine state and opens one for this state
+     * @param state Static string naming the state entered
+     */
+    void enterState(const char* state);
+
+    /**
+     * @brief Writes all events as Chrome trace JSON
+     * @param processName Shown as the process (e.g. the machine id)
+     * @return Number of events written, -1 if the file could not be written
+     */
+    long writeChromeTrace(const std::string& path, const std::string& processName) const;
+
+    /**
+     * @brief Events dropped because a buffer was full or no buffer was free
+     */
+    std::uint64_t dropped() const;
+
+private:
+    struct ThreadBuffer {
+        std::thread::id owner;
+        std::string threadName;
+        std::unique_ptr<TraceEvent[]> events;
+        std::atomic<std::size_t> size{0};       ///< Published events (release by the owner)
+        std::atomic<std::uint64_t> dropped{0};
+    };
+
+    ThreadBuffer* bufferOfThisThread();
+    TraceEvent* reserve(ThreadBuffer*& buffer);
+
+    const std::chrono::steady_clock::time_point origin;
+    const std::size_t capacity;
+    const std::uint64_t serial;                 ///< Tells recorders apart in the thread-local cache
+    std::array<std::atomic<ThreadBuffer*>, MAX_THREADS> buffers{};
+    std::atomic<std::uint64_t> unbuffered{0};   ///< Events of threads beyond MAX_THREADS
+
+    // State track: rare changes, so a mutex is fine here
+    mutable std::mutex stateMutex;
+    std::vector<TraceEvent> stateSpans;         ///< Closed state spans (at most capacity)
+    const char* currentState = nullptr;
+    std::int64_t currentStateSinceNs = 0;
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records the duration of a scope as a span
+ *
+ * Does nothing (no clock read) when the recorder is null.
+ */
+class TraceSpan {
+public:
+    TraceSpan(TraceRecorder* recorder, const char* name, const char* category = "machine")
+        : recorder(recorder)
+        , name(name)
+        , category(category)
+        , startNs(recorder != nullptr ? recorder->nowNs() : 0)
+    {}
+
+    ~TraceSpan() {
+        if (recorder != nullptr) {
+            recorder->span(name, category, startNs, recorder->nowNs());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    TraceRecorder* recorder;
+    const char* name;
+    const char* category;
+    std::int64_t startNs;
+};
+
+/**
+ * @class TraceEventSink
+ * @brief Records machine events as instants (category = severity)
+ */
+class TraceEventSink : public EventSink {
+public:
+    explicit TraceEventSink(TraceRecorder& recorder) : recorder(recorder) {}
+    void consume(const StatusEvent& event) override;
+
+private:
+    TraceRecorder& recorder;
+};
+
+#endif // LABELM_TRACE_H
@@ -0,0 +1,95 @@
+/**
+ * @file labelm_types.h
+ * @brief Core value types shared by the LM-3000 control modules
+ *
+ * Configuration, machine state and sensor definitions live here so that
+ * support modules (logging, events, statistics) can use them without
+ * pulling in the full LabelingMachine class.
+ */
+#ifndef LABELM_TYPES_H
+#define LABELM_TYPES_H
+
+#include <iostream>
+
+// Configuration parameters and limits
+// Define the configuration structure with default values
+struct MachineConfig {
+    int defaultSpeed = 150;            // mm/s - Normal operating speed
+    int maxSpeed = 300;                // mm/s - Maximum safe speed
+    int minSpeed = 50;                 // mm/s - Minimum operating speed
+    int maintenanceSpeed = 20;         // mm/s - Speed for maintenance mode
+    int initialLabelCount = 1000;      // Initial labels in roll
+    int lowLabelThreshold = 50;        // Low label warning threshold
+    double nominalTemperature = 22.5;  // °C - Normal operating temperature
+    double maxTemperature = 65.0;      // °C - Maximum safe temperature 
+    int productPitch = 300;            // mm - Conveyor distance between products (ideal rate = maxSpeed / productPitch)
+    int rollWarningLead = 300;         // s - Warn this long before the roll is forecast to run out (0: off)
+    int rampAcceleration = 100;        // mm/s² - Largest acceleration of rampSpeed()
+    int rampJerk = 500;                // mm/s³ - Largest jerk of an S-curve rampSpeed()
+    
+    // Helper function to display current configuration
+    void print() const {
+        std::cout << "\n--- Current Machine Configuration ---\n";
+        std::cout << "  Default Speed: " << defaultSpeed << " mm/s\n        ";
+        std::cout << "  Max Speed: " << maxSpeed << " mm/s\n        ";
+        std::cout << "  Min Speed: " << minSpeed << " mm/s      \n        ";
+        std::cout << "  Maintenance Speed: " << maintenanceSpeed << " mm/s\n        ";
+        std::cout << "  Initial Label Count: " << initialLabelCount << "\n        ";
+        std::cout << "  Low Label Threshold: " << lowLabelThreshold << "\n        ";
+        std::cout << "  Nominal Temperature: " << nominalTemperature << " °C\n        ";
+        std::cout << "  Max Temperature: " << maxTemperature << " °C\n        ";
+        std::cout << "  Product Pitch: " << productPitch << " mm\n        ";
+        std::cout << "  Roll Warning Lead: " << rollWarningLead << " s\n        ";
+        std::cout << "  Ramp Acceleration: " << rampAcceleration << " mm/s²\n        ";
+        std::cout << "  Ramp Jerk: " << rampJerk << " mm/s³\n";
+        std::cout << "----------------------------------------\n";
+    }
+};
+
+/**
+ * @enum MachineState
+ * @brief Represents the operational state of the labeling machine
+ *
+ * State transitions are controlled and validated by the LabelingMachine class.
+ * Invalid state transitions are rejected to ensure safe operation.
+ */
+enum class MachineState {
+    IDLE,           ///< Machine is powered on but not operating
+    RUNNING,        ///< Machine is actively labeling products
+    LOW_LABEL,      ///< Machine is actively labeling products with low label warning
+    PAUSED,         ///< Machine is temporarily halted (can resume)
+    ERROR,          ///< Machine has encountered an error condition
+    MAINTENANCE     ///< Machine is in maintenance/calibration mode
+};
+
+/**
+ * @brief Upper-case name of a state, as shown to operators and in metrics and traces
+ * @return "?" for a value that is not a MachineState (e.g. from a corrupt status block)
+ */
+constexpr const char* machineStateName(MachineState state) {
+    switch (state) {
+        case MachineState::IDLE:        return "IDLE";
+        case MachineState::RUNNING:     return "RUNNING";
+        case MachineState::LOW_LABEL:   return "LOW_LABEL";
+        case MachineState::PAUSED:      return "PAUSED";
+        case MachineState::ERROR:       return "ERROR";
+        case MachineState::MAINTENANCE: return "MAINTENANCE";
+    }
+    return "?";
+}
+
+/**
+ * @struct SensorData
+ * @brief Aggregates all sensor readings from the machine
+ *
+ * This structure represents the physical sensor inputs that would
+ * typically come from hardware interfaces in a real industrial system.
+ */
+struct SensorData {
+    bool productDetected;       ///< Photoelectric sensor - product present
+    int conveyorSpeed;          ///< Motor speed in mm/s
+    int labelRollRemaining;     ///< Remaining labels in current roll
+    double temperature;         ///< System temperature in Celsius
+};
+
+#endif // LABELM_TYPES_H
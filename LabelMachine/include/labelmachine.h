@@ -35,67 +35,58 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
-// Configuration parameters and limits
-// Define the configuration structure with default values
-struct MachineConfig {
-    int defaultSpeed = 150;            // mm/s - Normal operating speed
-    int maxSpeed = 300;                // mm/s - Maximum safe speed
-    int minSpeed = 50;                 // mm/s - Minimum operating speed
-    int maintenanceSpeed = 20;         // mm/s - Speed for maintenance mode
-    int initialLabelCount = 1000;      // Initial labels in roll
-    int lowLabelThreshold = 50;        // Low label warning threshold
-    double nominalTemperature = 22.5;  // °C - Normal operating temperature
-    double maxTemperature = 65.0;      // °C - Maximum safe temperature 
-    
-    // Helper function to display current configuration
-    void print() const {
-        std::cout << "\n--- Current Machine Configuration ---\n";
-        std::cout << "  Default Speed: " << defaultSpeed << " mm/s\n        ";
-        std::cout << "  Max Speed: " << maxSpeed << " mm/s\n        ";
-        std::cout << "  Min Speed: " << minSpeed << " mm/s      \n        ";
-        std::cout << "  Maintenance Speed: " << maintenanceSpeed << " mm/s\n        ";
-        std::cout << "  Initial Label Count: " << initialLabelCount << "\n        ";
-        std::cout << "  Low Label Threshold: " << lowLabelThreshold << "\n        ";
-        std::cout << "  Nominal Temperature: " << nominalTemperature << " °C\n        ";
-        std::cout << "  Max Temperature: " << maxTemperature << " °C\n";
-        std::cout << "----------------------------------------\n";
-    }
-};
+#include "labelm_types.h"
+#include "labelm_batch.h"
+#include "labelm_checkpoint.h"
+#include "labelm_configwatch.h"
+#include "labelm_events.h"
+#include "labelm_forecast.h"
+#include "labelm_journal.h"
+#include "labelm_logger.h"
+#include "labelm_metrics.h"
+#include "labelm_oee.h"
+#include "labelm_ramp.h"
+#include "labelm_replay.h"
+#include "labelm_ringlog.h"
+#include "labelm_rotation.h"
+#include "labelm_statemachine.h"
+#include "labelm_stats.h"
+#include "labelm_status.h"
+#include "labelm_time.h"
+#include "labelm_trace.h"
 
-/**
- * @enum MachineState
- * @brief Represents the operational state of the labeling machine
- *
- * State transitions are controlled and validated by the LabelingMachine class.
- * Invalid state transitions are rejected to ensure safe operation.
- */
-enum class MachineState {
-    IDLE,           ///< Machine is powered on but not operating
-    RUNNING,        ///< Machine is actively labeling products
-    LOW_LABEL,      ///< Machine is actively labeling products with low label warning
-    PAUSED,         ///< Machine is temporarily halted (can resume)
-    ERROR,          ///< Machine has encountered an error condition
-    MAINTENANCE     ///< Machine is in maintenance/calibration mode
-};
+// Define the name of the log file
+const std::string LOG_FILE_NAME = "production_log.txt";
+// Define the name of the binary production journal
+const std::string JOURNAL_FILE_NAME = "production_journal.lmj";
+// Define the name of the memory-mapped ring log
+const std::string RING_LOG_FILE_NAME = "production_ring.lmr";
 
 /**
- * @struct SensorData
- * @brief Aggregates all sensor readings from the machine
+ * @struct MachineOptions
+ * @brief Construction-time settings of a LabelingMachine
  *
- * This structure represents the physical sensor inputs that would
- * typically come from hardware interfaces in a real industrial system.
+ * The defaults reproduce a single stand-alone machine: id LM3000-001, CSV
+ * log in LOG_FILE_NAME and every event printed to the console.
  */
-struct SensorData {
-    bool productDetected;       ///< Photoelectric sensor - product present
-    int conveyorSpeed;          ///< Motor speed in mm/s
-    int labelRollRemaining;     ///< Remaining labels in current roll
-    double temperature;         ///< System temperature in Celsius
+struct MachineOptions {
+    std::string machineId = "LM3000-001";                   ///< Unique machine identifier
+    LogOptions log;                                         ///< Production log opened on construction
+    EventSeverity consoleSeverity = EventSeverity::DEBUG;   ///< Console threshold (OFF: no console sink)
+    const MachineClock* clock = nullptr;                    ///< Time source (null: system clock); must outlive the machine
+    std::chrono::nanoseconds shiftLength = std::chrono::hours(8); ///< Length of the OEE shift window
+    bool statusBlock = false;                               ///< Publish live status in shared memory (labelm_status.h)
+    int metricsPort = -1;                                   ///< Serve /metrics on 127.0.0.1:port (0: any free port, -1: off)
+    bool latencyStats = false;                              ///< Record operation latencies (labelm_latency.h); implied by metricsPort
+    std::size_t traceEvents = 0;                            ///< Trace buffer size per thread (labelm_trace.h; 0: no tracing)
+    std::string checkpointPath;                             ///< Persist counters across restarts (labelm_checkpoint.h; empty: off)
+    RampEngine* rampEngine = nullptr;                       ///< Advances rampSpeed() ramps (null: RampEngine::shared()); must outlive the machine
 };
 
-// Define the name of the log file
-const std::string LOG_FILE_NAME = "production_log.txt";
-
 /**
  * @class LabelingMachine
  * @brief Main controller class for the ESPERA LM-3000 labeling machine
@@ -105,7 +96,11 @@ const std::string LOG_FILE_NAME = "production_log.txt";
  * machine operation while enforcing business rules and safety constraints.
  *
  * Thread Safety: This class is NOT thread-safe. External synchronization
- * required if accessed from multiple threads.
+ * required if accessed from multiple threads. The exception is the
+ * configuration: reloadConfig() (and the watch of watchConfig()) may run on
+ * another thread while the machine is labeling. Event sinks are only called
+ * from the thread that owns the machine; a sink shared by machines owned by
+ * different threads must be thread-safe itself.
  *
  * Example Usage:
  * @code
@@ -120,25 +115,75 @@ class LabelingMachine {
 private:
     // Machine State
     MachineState state;                 ///< Current operational state
-    MachineState previousState;         ///< State before pause/error (for resume)
+    MachineState previousState;         ///< State before the last transition
 
     // Sensor Interface
     SensorData sensors;                 ///< Current sensor readings
     SensorData previousSensors;         ///< Previous sensor readings
+    RampEngine* rampEngine;             ///< Never null
+    std::shared_ptr<SpeedRamp> ramp;    ///< Running rampSpeed() ramp, null when none
 
     // Machine Configuration
-    MachineConfig config;               ///< Configurable machine parameters
+    // The labeling path reads the current snapshot without locking. A reload
+    // publishes a new snapshot and keeps the old ones, so a reference taken
+    // by a reader never dangles (a reload costs one MachineConfig).
+    std::atomic<const MachineConfig*> config;   ///< Current snapshot, never null
+    std::vector<std::unique_ptr<const MachineConfig>> configSnapshots; ///< All published snapshots (guarded by configMutex)
+    std::mutex configMutex;             ///< Serializes loadConfig() and reloadConfig()
+    std::unique_ptr<ConfigWatcher> configWatcher; ///< Watch started by watchConfig(), null when not watching
+    std::atomic<std::uint32_t> configVersion{0}; ///< Snapshots published so far
+
+    // Events of reloadConfig(), which may run on the watcher thread. Sinks are
+    // only called from the thread that owns the machine: it emits these on
+    // its next status publication.
+    struct DeferredEvent {
+        EventCode code;
+        int value1;
+        int value2;
+        int value3;
+        double measurement;
+        std::string detail;
+        bool hasDetail;
+    };
+    std::mutex deferredMutex;
+    std::vector<DeferredEvent> deferredEvents;  ///< Guarded by deferredMutex
+    std::atomic<bool> eventsDeferred{false};    ///< deferredEvents is not empty
 
     // Production Metrics
     int productsLabeled;                ///< Total products labeled in current session
     int errorCount;                     ///< Total errors encountered
+    std::unique_ptr<CounterCheckpoint> checkpoint; ///< Persisted counters, null unless enabled
+    bool countersRestored = false;      ///< Counters came from the checkpoint; the next loadConfig() keeps the roll
+    BatchScheduler batches;             ///< Active batch and pending work orders
+    RollForecaster rollForecast;        ///< Label consumption rate for getRollForecast()
+    bool rollChangeWarned = false;      ///< ROLL_CHANGE_DUE emitted for the current roll
+
+    // Time source for logs and events (system or simulated)
+    const MachineClock* clock;          ///< Never null
+
+    // Running production statistics (updated by transition() and applyLabel())
+    ProductionStats stats;
+    OeeCalculator oee;                  ///< Sliding-window OEE
 
     // System Information
     std::string machineId;              ///< Unique machine identifier
     std::string firmwareVersion;        ///< Current firmware version
 
-    // File stream object for logging
-    std::ofstream logFile;              ///< Log file stream
+    // Timeline tracing; declared before the log and event sinks that record into it
+    std::unique_ptr<TraceRecorder> trace;   ///< Null unless MachineOptions::traceEvents is set
+
+    // Production log output (written by a background thread)
+    std::unique_ptr<LogSink> logSink;   ///< Active log sink, null when closed
+    std::string logPath;                ///< File written by logSink
+    bool logDisabled = false;           ///< Opened with LogFormat::DISABLED
+    TimestampFormatter timestampFormatter; ///< Cached formatter for getCurrentTime()
+
+    // Operator/monitoring output
+    EventDispatcher events;             ///< Event sinks (console by default)
+    std::unique_ptr<StatusPublisher> statusPublisher; ///< Shared-memory status, null unless enabled
+    std::unique_ptr<MachineMetrics> metrics;    ///< Null unless MachineOptions::metricsPort is set
+    std::unique_ptr<LatencyRecorder> latency;   ///< Null unless latencyStats or metricsPort is set
+    std::unique_ptr<MetricsServer> metricsServer; ///< Reads metrics and latency; declared after them so it stops first
 
     /**
      * @brief Validates if requested speed is within safe operating limits
@@ -146,7 +191,16 @@ private:
      * @return true if speed is safe, false otherwise
      */
     bool isSpeedValid(int speed) const {
-        return speed >= config.minSpeed && speed <= config.maxSpeed;
+        const MachineConfig& limits = currentConfig();
+        return speed >= limits.minSpeed && speed <= limits.maxSpeed;
+    }
+
+    /**
+     * @brief Limits a speed to the current minSpeed..maxSpeed
+     */
+    int clampSpeed(int speed) const {
+        const MachineConfig& limits = currentConfig();
+        return std::min(std::max(speed, limits.minSpeed), limits.maxSpeed);
     }
 
     /**
@@ -154,7 +208,7 @@ private:
      * @return true if temperature is safe, false otherwise
      */
     bool isTemperatureSafe() const {
-        return sensors.temperature < config.maxTemperature;
+        return sensors.temperature < currentConfig().maxTemperature;
     }
 
     /**
@@ -162,9 +216,164 @@ private:
      * @return true if temperature is safe, false otherwise
      */
     bool isLowerLabels() const {
-        return sensors.labelRollRemaining < config.lowLabelThreshold;
+        return sensors.labelRollRemaining < currentConfig().lowLabelThreshold;
     }
 
+    /**
+     * @brief Entry/exit actions of one state, run by transition()
+     */
+    struct StateHooks {
+        void (LabelingMachine::*onEnter)();     ///< After the state is entered (may be null)
+        void (LabelingMachine::*onExit)();      ///< Before the state is left (may be null)
+    };
+
+    /// Hooks indexed by MachineState
+    static const StateHooks STATE_HOOKS[MACHINE_STATE_COUNT];
+
+    void onEnterIdle();
+    void onEnterPaused();
+    void onEnterMaintenance();
+
+    /**
+     * @brief Applies a state event through STATE_TRANSITIONS
+     *
+     * Looks up the target state; if the state changes, runs the exit hook
+     * of the old state, records it in previousState and runs the entry
+     * hook of the new one. Legal events that keep the state run no hooks.
+     *
+     * @param event Event to apply
+     * @return false if the event is not legal in the current state (no change)
+     */
+    bool transition(StateEvent event);
+
+    /**
+     * @brief Current configuration snapshot (lock-free, any thread)
+     */
+    const MachineConfig& currentConfig() const {
+        return *config.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Makes a copy of next the current configuration snapshot
+     *
+     * Caller holds configMutex (except during construction).
+     */
+    void publishConfig(const MachineConfig& next);
+
+    /**
+     * @brief Reads a configuration file into parsed
+     *
+     * Keys missing from the file and values out of range keep the value
+     * already in parsed; each rejected value emits CONFIG_VALUE_INVALID
+     * and is counted in invalidValues.
+     *
+     * @param deferEvents Queue the events for the owning thread instead of emitting them
+     * @return false if the file cannot be opened (CONFIG_FILE_MISSING emitted)
+     */
+    bool parseConfig(const std::string& filename, MachineConfig& parsed, int& invalidValues, bool deferEvents);
+
+    /**
+     * @brief Emits a configuration event now, or queues it for the owning thread if deferred
+     */
+    void configEvent(bool deferred, EventCode code, int value1 = 0, int value2 = 0, int value3 = 0,
+                     double measurement = 0.0, const char* detail = nullptr);
+
+    /**
+     * @brief Emits the events queued by reloadConfig()
+     */
+    void emitDeferredEvents();
+
+    /**
+     * @brief Refreshes the counter checkpoint, status block and metric gauges, if enabled
+     *
+     * Called by every operation that changes state, sensors or counters.
+     */
+    void publishStatus() {
+        if (eventsDeferred.load(std::memory_order_acquire)) {
+            emitDeferredEvents();
+        }
+        if (ramp) {
+            adoptRampSpeed();
+        }
+        if (checkpoint) {
+            checkpoint->save({productsLabeled, errorCount, sensors.labelRollRemaining});
+        }
+        if (metrics) {
+            updateMetrics();
+        }
+        if (statusPublisher) {
+            writeStatus();
+        }
+    }
+
+    void writeStatus();
+    void updateMetrics();
+
+    /**
+     * @brief Takes over the ramp setpoint as conveyor speed; emits SPEED_RAMP_COMPLETE at the target
+     */
+    void adoptRampSpeed();
+
+    /**
+     * @brief Stops the running ramp at its current setpoint (SPEED_RAMP_CANCELLED)
+     */
+    void cancelRamp();
+
+    /**
+     * @brief Emits LATENCY_SUMMARY for every operation recorded so far
+     */
+    void emitLatencySummary();
+
+    /**
+     * @brief Starts the next pending work order, loading its roll if the current one cannot finish it
+     */
+    void advanceBatch();
+
+    /**
+     * @brief Puts a roll with this many labels on the machine (re-arms ROLL_CHANGE_DUE)
+     */
+    void setRoll(int labels) {
+        sensors.labelRollRemaining = labels;
+        rollChangeWarned = false;
+    }
+
+    /**
+     * @brief Emits ROLL_CHANGE_DUE once per roll when the forecast time to empty drops below rollWarningLead
+     */
+    void checkRollForecast() {
+        const int lead = currentConfig().rollWarningLead;
+        const double seconds = rollForecast.secondsToEmpty(sensors.labelRollRemaining);
+        if (lead > 0 && seconds >= 0.0 && seconds <= lead) {
+            rollChangeWarned = true;
+            emitEvent(EventCode::ROLL_CHANGE_DUE, static_cast<int>(seconds), sensors.labelRollRemaining, 0,
+                      rollForecast.labelsPerMinute());
+        }
+    }
+
+    /**
+     * @brief Recomputes the OEE ideal rate (maxSpeed / productPitch) from config
+     */
+    void updateIdealRate();
+
+    /**
+     * @brief Emits a machine event if any sink accepts its severity
+     *
+     * The severity check happens before the event is built, so suppressed
+     * events cost a single compare.
+     */
+    void emitEvent(EventCode code, int value1 = 0, int value2 = 0, int value3 = 0,
+                   double measurement = 0.0, const char* detail = nullptr) {
+        if (events.wants(eventSeverity(code))) {
+            dispatchEvent(code, value1, value2, value3, measurement, detail);
+        }
+    }
+
+    /**
+     * @brief Builds and dispatches an event (called after filtering)
+     */
+    void dispatchEvent(EventCode code, int value1, int value2, int value3,
+                       double measurement, const char* detail);
+
 public:
     /**
      * @brief Constructs a new LabelingMachine instance with default settings
@@ -173,6 +382,16 @@ public:
      * In a real system, this would also initialize hardware interfaces.
      */
     LabelingMachine();
+
+    /**
+     * @brief Constructs a machine with the given id, log and console settings
+     *
+     * Used when several machines run in one process (see FleetController):
+     * each needs its own id and log file.
+     *
+     * @param options Construction-time settings
+     */
+    explicit LabelingMachine(const MachineOptions& options);
     /**
      * @brief Destructor - ensures machine is safely stopped
      */
@@ -227,9 +446,23 @@ public:
      * In a real system, this would be called by an interrupt handler
      * or sensor polling routine. When a product is detected and the
      * machine is running, label application is automatically triggered.
+     *
+     * Runs the label cycle (including logging and events) inline; sensor
+     * producers on other threads should go through SensorIngestion
+     * (labelm_sensors.h), which calls this from the control thread.
      */
     void detectProduct(bool detected);
 
+    /**
+     * @brief Records a reading of the temperature monitoring system
+     *
+     * The reading is checked against maxTemperature on the next start()
+     * or resume().
+     *
+     * @param celsius Measured system temperature in °C
+     */
+    void updateTemperature(double celsius);
+
     /**
      * @brief Displays comprehensive machine status
      *
@@ -249,6 +482,46 @@ public:
      */
     bool setSpeed(int speed);
 
+    /**
+     * @brief Moves the conveyor to a new speed along a ramp, without blocking
+     *
+     * The ramp starts from the current speed and is limited by the
+     * rampAcceleration (and, for S_CURVE, rampJerk) settings. The ramp
+     * engine (MachineOptions::rampEngine) publishes the setpoint on its own
+     * control tick; the machine takes the setpoint for its current time as
+     * conveyor speed on every operation and on updateSpeedRamp(). The ramp
+     * runs on the machine's clock, so on a SimulationClock it follows
+     * simulated time. setSpeed(), another rampSpeed(), setClock() and
+     * leaving the labeling states (stop(), pause(), a fault) cancel the
+     * ramp at the speed it has reached.
+     *
+     * Accepted in the same states and range as setSpeed(). The adopted
+     * speed is kept within the minSpeed..maxSpeed in effect at the time,
+     * also when a reloadConfig() narrows them during the ramp.
+     *
+     * @param speed Target speed in mm/s
+     * @param profile Shape of the ramp
+     * @return true if the ramp was started
+     */
+    bool rampSpeed(int speed, RampProfile profile = RampProfile::S_CURVE);
+
+    /**
+     * @brief Takes over the current ramp setpoint as conveyor speed
+     *
+     * For control loops that are between products; cheap when no ramp runs.
+     * SensorIngestion calls it on every pass of its control thread.
+     */
+    void updateSpeedRamp() {
+        if (ramp && (ramp->elapsedSeconds() >= ramp->duration() || clampSpeed(ramp->speedNow()) != sensors.conveyorSpeed)) {
+            publishStatus();    // Adopts the setpoint
+        }
+    }
+
+    /**
+     * @brief true while a rampSpeed() ramp runs (until its target speed has been taken over)
+     */
+    bool isRamping() const { return ramp != nullptr; }
+
     /**
      * @brief Gets current machine state
      * @return Current MachineState
@@ -260,12 +533,42 @@ public:
      * @return Number of products labeled in current session
      */
     int getProductionCount() const;
+
+    /**
+     * @brief Gets the production statistics of the current session
+     *
+     * Constant time: totals are maintained incrementally on every state
+     * change and label, the open interval of the current state is added
+     * on the fly. The session starts on construction, resetCounters() and
+     * setClock().
+     *
+     * @return Time per state, labels/min, efficiency and success rate
+     */
+    ProductionStatistics getStatistics() const;
+
+    /**
+     * @brief Gets the Overall Equipment Effectiveness
+     *
+     * Availability, performance (against maxSpeed / productPitch) and
+     * quality over the last minute, the last 15 minutes and the last
+     * shift (MachineOptions::shiftLength), from fixed-size bucket rings.
+     *
+     * @return OEE and its factors per window
+     */
+    OeeReport getOee() const;
+
+    /**
+     * @brief Gets the machine identifier
+     * @return Unique machine id
+     */
+    const std::string& getMachineId() const;
     
     /**
      * @brief Resets production counters
      *
      * Should only be called when machine is idle.
-     * Used at start of new production run.
+     * Used at start of new production run. Also starts a new
+     * statistics session.
      */
     void resetCounters();
     
@@ -318,11 +621,265 @@ public:
     bool exitMaintenance();
 
     std::string getCurrentTime();
-    void openLog();
+
+    /**
+     * @brief Writes the current local time into a caller-provided buffer
+     *
+     * Allocation-free; the calendar conversion is cached per minute.
+     *
+     * @param buffer Output buffer (TimestampFormatter::BUFFER_SIZE is always enough)
+     * @param size Size of buffer in bytes
+     * @param withMillis Append `.mmm` after the seconds
+     * @return Number of characters written, 0 if the buffer is too small
+     */
+    std::size_t getCurrentTime(char* buffer, std::size_t size, bool withMillis = false);
+
+    /**
+     * @brief Opens the production log and starts the logger thread
+     *
+     * By default truncates LOG_FILE_NAME and writes the CSV header. With
+     * LogFormat::BINARY_JOURNAL a compact fixed-width journal is written to
+     * JOURNAL_FILE_NAME instead (convert with `labelm-export`). Rows are
+     * queued by logEntry() and written/flushed by a background thread
+     * according to the given queue, overflow and flush policy.
+     *
+     * LogFormat::MAPPED_RING keeps the newest records in the memory-mapped
+     * ring RING_LOG_FILE_NAME. It is not truncated on open, needs no logger
+     * thread (a write is a few memory stores) and survives a crash of the
+     * controller; `labelm-export` recovers its contents.
+     *
+     * LogFormat::DISABLED turns production logging off; logEntry() then
+     * returns without writing or reporting an error.
+     *
+     * @param options Log format, file and logger thread tuning
+     */
+    void openLog(const LogOptions& options = LogOptions());
     void closeLog();
+
+    /**
+     * @brief Queues a production log row for the current product
+     * @param status "SUCCESS" or "FAILURE"
+     */
     void logEntry(const std::string& status);
+
+    /**
+     * @brief Queues a production log row for the current product
+     *
+     * Only builds a fixed-size LogRecord and pushes it to the log queue;
+     * formatting and disk I/O happen on the logger thread.
+     *
+     * @param status Label outcome
+     */
+    void logEntry(LogStatus status);
+
+    /**
+     * @brief Gets queued/written/dropped counters of the production log
+     * @return Counters of the active log, all zero when the log is closed
+     */
+    LogWriterStats getLogStats() const;
+
+    /**
+     * @brief Rebuilds counters from a CSV production log after a restart
+     *
+     * Replays the log (see labelm_replay.h) and restores productsLabeled,
+     * errorCount and the last logged temperature. The last logged speed is
+     * reported in the summary; the conveyor itself restarts at
+     * defaultSpeed on start(). Open the log with LogOptions::append so the
+     * previous session is not truncated on construction. Only allowed in
+     * IDLE.
+     *
+     * Once segments of a rotated log exist they are the source, even if
+     * a plain file from before rotation is still there. A rotated log is
+     * restored from its newest segment with rows;
+     * errorCount adds up the FAILURE rows of all segments still on disk
+     * (compressed ones are read through zlib), so segments removed by
+     * retention no longer count.
+     *
+     * @param path CSV log to replay (empty: the machine's current CSV log)
+     * @param summary Optional; receives the replay result
+     * @return true if the log was replayed and the counters restored
+     */
+    bool restoreFromLog(const std::string& path = std::string(), ReplaySummary* summary = nullptr);
     void loadConfig(const std::string& filename);
 
+    /**
+     * @brief Applies a changed configuration file to a running machine
+     *
+     * Only the settings that are safe to change during production are
+     * taken over: defaultSpeed, minSpeed, maxSpeed, maintenanceSpeed,
+     * lowLabelThreshold, maxTemperature, rollWarningLead, rampAcceleration
+     * and rampJerk (for ramps started afterwards). initialLabelCount,
+     * nominalTemperature and productPitch need loadConfig() (the OEE ideal
+     * rate also keeps its loadConfig() value). The file is validated as a
+     * whole: a missing file, any invalid value or minSpeed above maxSpeed
+     * rejects the reload and the current configuration stays in effect.
+     *
+     * The new settings are published as one snapshot, so the labeling path
+     * never sees a mix of old and new values. They apply from the next
+     * check on; a conveyor already running faster than a lowered maxSpeed
+     * keeps its speed until the next setSpeed().
+     *
+     * Safe to call from any thread (the watcher thread of watchConfig()).
+     * Its events (CONFIG_LOADING ... CONFIG_RELOADED or
+     * CONFIG_RELOAD_REJECTED) are queued and emitted by the thread that
+     * owns the machine on its next operation, so event sinks never run on
+     * the calling thread.
+     *
+     * @param filename Configuration file
+     * @return true if the new settings are in effect
+     */
+    bool reloadConfig(const std::string& filename);
+
+    /**
+     * @brief Reloads the configuration whenever the file is rewritten
+     *
+     * Starts a ConfigWatcher that calls reloadConfig() from its own thread.
+     * Replaces any previous watch.
+     *
+     * @param filename Configuration file to watch
+     * @return false if the file's directory cannot be watched
+     */
+    bool watchConfig(const std::string& filename);
+
+    /**
+     * @brief Stops the watch started by watchConfig()
+     */
+    void unwatchConfig();
+
+    /**
+     * @brief Gets a copy of the configuration currently in effect
+     */
+    MachineConfig getConfig() const { return currentConfig(); }
+
+    /**
+     * @brief Port of the metrics endpoint (0 if not serving)
+     */
+    int getMetricsPort() const { return metricsServer ? metricsServer->port() : 0; }
+
+    /**
+     * @brief Live metrics (null unless MachineOptions::metricsPort is set)
+     *
+     * Lets a process running several machines serve them from one
+     * endpoint with appendMetricsText().
+     */
+    const MachineMetrics* getMetrics() const { return metrics.get(); }
+
+    /**
+     * @brief Latency distribution of an operation (p50/p99/p99.9/max)
+     *
+     * Merges the per-thread histograms at the time of the call; empty
+     * unless MachineOptions::latencyStats or metricsPort is set.
+     */
+    LatencySummary getLatency(MetricOperation operation) const {
+        return latency ? latency->summary(operation) : LatencySummary();
+    }
+
+    /**
+     * @brief Latency recorder (null unless enabled), e.g. for appendMetricsText()
+     */
+    const LatencyRecorder* getLatencyRecorder() const { return latency.get(); }
+
+    /**
+     * @brief Starts a batch of quantity products right away
+     *
+     * Every label applied from now on counts into the batch. When the
+     * quantity is reached the batch completes and the next queued work
+     * order (queueWorkOrder()) starts without stopping the line.
+     *
+     * @return false if a batch is already active or quantity < 1 (BATCH_REJECTED)
+     */
+    bool startBatch(const std::string& batchId, int quantity);
+
+    /**
+     * @brief Appends a work order to the queue; starts it at once if no batch is active
+     * @return false if the quantity or roll size is invalid (BATCH_REJECTED)
+     */
+    bool queueWorkOrder(const WorkOrder& order);
+
+    /**
+     * @brief Cancels the active batch and advances to the next work order
+     * @return false if no batch is active
+     */
+    bool cancelBatch();
+
+    /**
+     * @brief Removes a pending work order
+     * @return false if no pending order has this id
+     */
+    bool cancelWorkOrder(const std::string& batchId);
+
+    /**
+     * @brief Progress of the active (or last) batch, O(1)
+     */
+    const BatchProgress& getBatchProgress() const { return batches.current(); }
+
+    /**
+     * @brief Number of work orders waiting behind the active batch
+     */
+    std::size_t getPendingWorkOrders() const { return batches.pending(); }
+
+    /**
+     * @brief Forecast of when the current roll runs out
+     *
+     * Based on an exponentially weighted average of the recent label
+     * interval (labelm_forecast.h). ROLL_CHANGE_DUE is emitted once per
+     * roll when the forecast drops below the rollWarningLead setting,
+     * well before the lowLabelThreshold warning and the ERROR stop of an
+     * empty roll.
+     */
+    RollForecast getRollForecast() const {
+        return rollForecast.forecast(sensors.labelRollRemaining, clock->nowNs());
+    }
+
+    /**
+     * @brief Writes the trace recorded so far as Chrome trace-event JSON
+     *
+     * Open the file in chrome://tracing or ui.perfetto.dev. It shows the
+     * machine state over time on its own track and, per thread, spans of
+     * start(), pause(), resume(), enterMaintenance(), exitMaintenance(),
+     * applyLabel() and log flushes, plus every machine event as an instant.
+     * Recording continues; a later call writes everything again.
+     *
+     * @return false if tracing is off (MachineOptions::traceEvents) or the file could not be written
+     */
+    bool writeTrace(const std::string& path);
+
+    /**
+     * @brief Replaces the machine's time source
+     *
+     * All log rows and events are stamped with this clock, so a
+     * SimulationClock keeps logs consistent with simulated time. The
+     * statistics session and OEE windows restart, as times of different
+     * clocks cannot be mixed. A running rampSpeed() ramp is cancelled.
+     *
+     * @param newClock Clock to use (null restores the system clock); must
+     *                 outlive the machine
+     */
+    void setClock(const MachineClock* newClock);
+
+    /**
+     * @brief Gets the machine's current time
+     * @return ns since the Unix epoch according to the machine's clock
+     */
+    std::int64_t now() const { return clock->nowNs(); }
+
+    /**
+     * @brief Attaches an event sink
+     *
+     * A console sink accepting all severities is attached on construction;
+     * call clearEventSinks() first to replace it (e.g. with a console sink
+     * limited to EventSeverity::WARNING plus a RingBufferEventSink).
+     *
+     * @param sink Sink to receive machine events
+     * @param minSeverity Lowest severity delivered to this sink
+     */
+    void addEventSink(std::shared_ptr<EventSink> sink, EventSeverity minSeverity = EventSeverity::DEBUG);
+
+    /**
+     * @brief Detaches all event sinks (including the default console)
+     */
+    void clearEventSinks();
+
 };
 
 
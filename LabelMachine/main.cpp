@@ -25,9 +25,67 @@
 #include <iostream>
 #include <string>
 #include <chrono>
-#include <thread>
 #include <iomanip>
 #include "labelmachine.h"
+#include "labelm_scheduler.h"
+
+/**
+ * @brief Simulates a full 8-hour shift on a virtual clock
+ *
+ * Products arrive every 2 seconds and the label roll is replaced before
+ * it runs low. The event scheduler jumps the clock from event to event,
+ * so the whole shift runs in milliseconds; the shift log still carries
+ * simulated timestamps. Console output is limited to warnings.
+ *
+ * @param configFile Configuration file for the simulated machine
+ */
+void simulateShift(const std::string& configFile) {
+    using namespace std::chrono;
+    const nanoseconds productInterval = seconds(2);
+    const nanoseconds shiftLength = hours(8);
+    const int rollSize = 1000;
+    const int labelsPerRoll = 950;      // Change rolls before the low-label threshold
+
+    SimulationClock shiftClock;
+    MachineOptions options;
+    options.machineId = "LM3000-SIM";
+    options.log.path = "shift_production_log.txt";
+    options.consoleSeverity = EventSeverity::WARNING;
+    options.clock = &shiftClock;
+    LabelingMachine shiftMachine(options);
+    shiftMachine.loadConfig(configFile);
+    shiftMachine.loadLabelRoll(rollSize);
+
+    EventScheduler scheduler(shiftClock);
+    const std::int64_t begin = shiftClock.nowNs();
+    const std::int64_t end = begin + shiftLength.count();
+    const std::size_t products = static_cast<std::size_t>(shiftLength / productInterval) - 1;
+
+    scheduler.scheduleAt(begin, ScheduledEventType::START);
+    scheduler.scheduleProducts(begin + productInterval.count(), products, productInterval, milliseconds(100));
+    for (std::int64_t t = begin + labelsPerRoll * productInterval.count() + productInterval.count() / 2;
+         t < end; t += labelsPerRoll * productInterval.count()) {
+        scheduler.scheduleAt(t, ScheduledEventType::ROLL_CHANGE, rollSize);
+    }
+    scheduler.scheduleAt(end, ScheduledEventType::STOP);
+
+    const auto wallStart = steady_clock::now();
+    std::size_t events = scheduler.runUntil(shiftMachine, end);
+    const double wallMs = duration<double, std::milli>(steady_clock::now() - wallStart).count();
+
+    const ProductionStatistics stats = shiftMachine.getStatistics();
+    std::cout << "[INFO] Simulated " << duration<double, std::ratio<3600>>(shiftLength).count()
+              << " h shift: " << events << " events, " << shiftMachine.getProductionCount()
+              << " products labeled in " << wallMs << " ms\n";
+    std::cout << "[INFO] Shift statistics: " << stats.labelsPerMinute << " labels/min, "
+              << stats.efficiency * 100.0 << " % efficiency, "
+              << duration<double, std::ratio<60>>(nanoseconds(stats.timeIn(MachineState::RUNNING))).count()
+              << " min running\n";
+    const OeeFigures shiftOee = shiftMachine.getOee().shift;
+    std::cout << "[INFO] Shift OEE: " << shiftOee.oee * 100.0 << " % (availability "
+              << shiftOee.availability * 100.0 << " %, performance " << shiftOee.performance * 100.0
+              << " %, quality " << shiftOee.quality * 100.0 << " %)\n";
+}
 
 /**
  * @brief Main program demonstrating machine operation
@@ -48,9 +106,17 @@ int main() {
     std::cout << "║   Industrial Labeling Machine Controller     ║\n";
     std::cout << "╚══════════════════════════════════════════════╝\n\n";
 
-    // Initialize machine
-    LabelingMachine machine;
+    // Production timing runs on a virtual clock; log timestamps follow it
+    SimulationClock clock;
+
+    // Initialize machine; HMIs can follow it live with labelm-status
+    MachineOptions options;
+    options.statusBlock = true;
+    LabelingMachine machine(options);
+    machine.setClock(&clock);
     machine.loadConfig(filename);
+    // Operators may tune limits while the line runs
+    machine.watchConfig(filename);
 
     // Display initial status
     machine.printStatus();
@@ -66,20 +132,20 @@ int main() {
     std::cout << ">>> Simulating production cycle (5 products)...\n\n";
     for (int i = 0; i < 5; i++) {
         // Simulate conveyor timing
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        clock.advanceBy(std::chrono::milliseconds(500));
 
         // Product enters labeling zone
         machine.detectProduct(true);
 
         // Small delay for product to exit
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        clock.advanceBy(std::chrono::milliseconds(100));
         machine.detectProduct(false);
     }
     // Simulate production cycle - label 6 products with paused and maintenance
     std::cout << "\n>>> Simulating production cycle (6 products) with paused and maintenance...\n";
     for (int i = 0; i < 10; i++) {
         // Simulate conveyor timing
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        clock.advanceBy(std::chrono::milliseconds(500));
         if(i == 3) machine.pause();
         if(i == 7) {
             machine.resume();
@@ -99,7 +165,7 @@ int main() {
         machine.detectProduct(true);
 
         // Small delay for product to exit
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        clock.advanceBy(std::chrono::milliseconds(100));
         machine.detectProduct(false);
     }
     // Check status mid-production
@@ -122,14 +188,14 @@ int main() {
     std::cout << "\n>>> Enter maintenance from status (IDLE) check:\n";
     machine.enterMaintenance();
     // Simulate conveyor timing
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    clock.advanceBy(std::chrono::milliseconds(500));
 
     // Check status mid-maintenance
     std::cout << "\n>>> Mid-Maintenance status check:\n";
     machine.printStatus();
    
     // Simulate conveyor timing
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    clock.advanceBy(std::chrono::milliseconds(500));
 
     // Exit maintenance
     machine.exitMaintenance();
@@ -147,7 +213,7 @@ int main() {
     std::cout << ">>> Simulating production cycle (5 products) after maintenance...\n\n";
     for (int i = 0; i < 70; i++) {
         // Simulate conveyor timing
-        // std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        clock.advanceBy(std::chrono::milliseconds(500));
         if(i == 10) machine.loadLabelRoll(55); 
         //if(i == 40) machine.loadLabelRoll(155); 
 
@@ -155,7 +221,7 @@ int main() {
         machine.detectProduct(true);
 
         // Small delay for product to exit
-        // std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        clock.advanceBy(std::chrono::milliseconds(100));
         machine.detectProduct(false);
     }
     // Check status mid-production
@@ -172,5 +238,8 @@ int main() {
 
     std::cout << ">>> Production session complete\n";
 
+    std::cout << "\n>>> Simulating a full shift...\n\n";
+    simulateShift(filename);
+
     return 0;
 }
@@ -0,0 +1,52 @@
+#include "labelm_batch.h"
+
+#include <algorithm>
+#include <utility>
+
+bool BatchScheduler::remove(const std::string& batchId) {
+    auto it = std::find_if(pendingOrders.begin(), pendingOrders.end(),
+                           [&](const WorkOrder& order) { return order.batchId == batchId; });
+    if (it == pendingOrders.end()) {
+        return false;
+    }
+    pendingOrders.erase(it);
+    return true;
+}
+
+void BatchScheduler::begin(const WorkOrder& order) {
+    progress.batchId = order.batchId;
+    progress.quantity = order.quantity;
+    progress.labeled = 0;
+    progress.status = BatchStatus::ACTIVE;
+    rollStaged = false;
+    // Short batches plan their changeover on the first label
+    stageAt = std::max(1, order.quantity - STAGE_LEAD_LABELS);
+}
+
+bool BatchScheduler::popNext(WorkOrder& order) {
+    if (pendingOrders.empty()) {
+        return false;
+    }
+    order = std::move(pendingOrders.front());
+    pendingOrders.pop_front();
+    return true;
+}
+
+BatchStep BatchScheduler::planChangeover(int rollRemaining) {
+    rollStaged = true;
+    const WorkOrder* following = next();
+    if (following == nullptr || following->rollLabels <= 0) {
+        return BatchStep::NONE;
+    }
+    // Labels left on the roll once this batch is done
+    const int leftAtChangeover = rollRemaining - progress.remaining();
+    return leftAtChangeover < following->quantity ? BatchStep::STAGE_ROLL : BatchStep::NONE;
+}
+
+bool BatchScheduler::cancel() {
+    if (progress.status != BatchStatus::ACTIVE) {
+        return false;
+    }
+    progress.status = BatchStatus::CANCELLED;
+    return true;
+}
@@ -0,0 +1,123 @@
+#include "labelm_checkpoint.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t CHECKPOINT_SLOTS = 2;
+constexpr std::size_t CHECKPOINT_FILE_SIZE = sizeof(CheckpointHeader) + CHECKPOINT_SLOTS * sizeof(CheckpointSlot);
+
+bool headerMatches(const CheckpointHeader* header) {
+    return std::memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) == 0
+        && header->version == CHECKPOINT_VERSION
+        && header->slotSize == sizeof(CheckpointSlot);
+}
+
+bool slotValid(const CheckpointSlot& slot) {
+    return slot.sequence != 0 && slot.checksum == checkpointChecksum(slot);
+}
+
+} // namespace
+
+std::uint32_t checkpointChecksum(const CheckpointSlot& slot) {
+    // FNV-1a over the 32-bit words before the checksum (5 multiplies per save)
+    std::uint32_t words[offsetof(CheckpointSlot, checksum) / sizeof(std::uint32_t)];
+    std::memcpy(words, &slot, sizeof(words));
+    std::uint32_t hash = 2166136261u;
+    for (std::uint32_t word : words) {
+        hash = (hash ^ word) * 16777619u;
+    }
+    return hash;
+}
+
+CounterCheckpoint::CounterCheckpoint(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info;
+    bool reuse = ::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) == CHECKPOINT_FILE_SIZE;
+    if (!reuse && (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(CHECKPOINT_FILE_SIZE)) != 0)) {
+        ::close(fd);
+        return;
+    }
+
+    void* mapping = ::mmap(nullptr, CHECKPOINT_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return;
+    }
+    header = static_cast<CheckpointHeader*>(mapping);
+    slots = reinterpret_cast<CheckpointSlot*>(static_cast<char*>(mapping) + sizeof(CheckpointHeader));
+
+    if (!reuse || !headerMatches(header)) {
+        // Fresh file: clear both slots, the magic goes in last
+        std::memset(mapping, 0, CHECKPOINT_FILE_SIZE);
+        header->version = CHECKPOINT_VERSION;
+        header->slotSize = sizeof(CheckpointSlot);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic));
+        return;
+    }
+    for (std::size_t i = 0; i < CHECKPOINT_SLOTS; i++) {
+        if (slotValid(slots[i]) && slots[i].sequence > lastSequence) {
+            lastSequence = slots[i].sequence;
+        }
+    }
+}
+
+CounterCheckpoint::~CounterCheckpoint() {
+    if (header != nullptr) {
+        ::msync(header, CHECKPOINT_FILE_SIZE, MS_ASYNC);
+        ::munmap(header, CHECKPOINT_FILE_SIZE);
+    }
+}
+
+bool CounterCheckpoint::restore(CheckpointCounters& counters) const {
+    if (header == nullptr || lastSequence == 0) {
+        return false;
+    }
+    const CheckpointSlot& slot = slots[lastSequence % CHECKPOINT_SLOTS];
+    counters.productsLabeled = slot.productsLabeled;
+    counters.errorCount = slot.errorCount;
+    counters.labelRollRemaining = slot.labelRollRemaining;
+    return true;
+}
+
+void CounterCheckpoint::save(const CheckpointCounters& counters) {
+    if (header == nullptr) {
+        return;
+    }
+    // Build the slot locally: checksumming it in the mapping would reload
+    // the fields just stored and stall on store forwarding
+    CheckpointSlot fresh;
+    fresh.sequence = lastSequence + 1;
+    fresh.productsLabeled = counters.productsLabeled;
+    fresh.errorCount = counters.errorCount;
+    fresh.labelRollRemaining = counters.labelRollRemaining;
+    const std::uint32_t checksum = checkpointChecksum(fresh);
+
+    // Overwrite the older slot; the newer one stays valid until the checksum lands
+    CheckpointSlot& slot = slots[fresh.sequence % CHECKPOINT_SLOTS];
+    slot.sequence = fresh.sequence;
+    slot.productsLabeled = fresh.productsLabeled;
+    slot.errorCount = fresh.errorCount;
+    slot.labelRollRemaining = fresh.labelRollRemaining;
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.checksum = checksum;
+    lastSequence = fresh.sequence;
+}
+
+void CounterCheckpoint::sync() {
+    if (header != nullptr) {
+        ::msync(header, CHECKPOINT_FILE_SIZE, MS_SYNC);
+    }
+}
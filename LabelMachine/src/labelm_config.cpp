@@ -1,107 +1,208 @@
 #include "labelmachine.h"
 
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "labelm_configschema.h"
+
+namespace {
+
 /**
- * @brief Resumes the labeling machine operation
- *
+ * @brief Reads a whole file into text (reusing its capacity)
  */
-void LabelingMachine::loadConfig(const std::string& filename) {
-    // For simplicity, we will simulate loading configuration from a file.
-    std::ifstream infile(filename);
-    std::map<std::string, std::string> temp_settings;
-    std::string line;
-    if(!infile.is_open()) {
-        std::cout << "[WARNING] Configuration file not found or cannot be opened: " << filename << "\n";    
-        std::cout << "[INFO] Using default settings.\n";
-        sensors.labelRollRemaining = config.initialLabelCount; // Initialize sensor value
-        sensors.temperature = config.nominalTemperature; // Initialize sensor value
+bool readFile(const std::string& path, std::string& text) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    text.resize(static_cast<std::size_t>(info.st_size));
+    std::size_t done = 0;
+    while (done < text.size()) {
+        const ssize_t length = ::read(fd, &text[done], text.size() - done);
+        if (length <= 0) {
+            break;      // Error or file shrank meanwhile: use what was read
+        }
+        done += static_cast<std::size_t>(length);
+    }
+    text.resize(done);
+    ::close(fd);
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Derives the OEE ideal rate from the configured top speed and product pitch
+ */
+void LabelingMachine::updateIdealRate() {
+    const MachineConfig& settings = currentConfig();
+    const double labelsPerSecond = settings.productPitch > 0
+        ? static_cast<double>(settings.maxSpeed) / settings.productPitch : 0.0;
+    oee.setIdealRate(labelsPerSecond, clock->nowNs());
+}
+
+/**
+ * @brief Publishes a copy of next as the current configuration
+ */
+void LabelingMachine::publishConfig(const MachineConfig& next) {
+    configSnapshots.emplace_back(new MachineConfig(next));
+    config.store(configSnapshots.back().get(), std::memory_order_release);
+    // Picked up by the next status publication on the labeling thread
+    configVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LabelingMachine::configEvent(bool deferred, EventCode code, int value1, int value2, int value3,
+                                  double measurement, const char* detail) {
+    if (!deferred) {
+        emitEvent(code, value1, value2, value3, measurement, detail);
         return;
     }
+    // Sink thresholds belong to the owning thread: filtered when emitted
+    std::lock_guard<std::mutex> lock(deferredMutex);
+    deferredEvents.push_back({code, value1, value2, value3, measurement,
+                              detail != nullptr ? detail : "", detail != nullptr});
+    eventsDeferred.store(true, std::memory_order_release);
+}
 
-    std::cout << "[INFO] Loading configuration from " << filename << "\n";
-    while(std::getline(infile, line)) {
-        // Skip comments and empty lines
-        if(line.empty() || line[0] == '#') continue;
+void LabelingMachine::emitDeferredEvents() {
+    std::vector<DeferredEvent> queued;
+    {
+        std::lock_guard<std::mutex> lock(deferredMutex);
+        queued.swap(deferredEvents);
+        eventsDeferred.store(false, std::memory_order_relaxed);
+    }
+    for (const DeferredEvent& event : queued) {
+        emitEvent(event.code, event.value1, event.value2, event.value3, event.measurement,
+                  event.hasDetail ? event.detail.c_str() : nullptr);
+    }
+}
+
+bool LabelingMachine::parseConfig(const std::string& filename, MachineConfig& parsed, int& invalidValues,
+                                  bool deferEvents) {
+    // Reused across calls: loading a whole fleet allocates the buffer once
+    static thread_local std::string text;
+    if (!readFile(filename, text)) {
+        configEvent(deferEvents, EventCode::CONFIG_FILE_MISSING, 0, 0, 0, 0.0, filename.c_str());
+        return false;
+    }
 
-        size_t pos = line.find('=');
-        if (pos == std::string::npos) continue;
-        std::string key = line.substr(0, pos);
-        std::string value = line.substr(pos + 1);
-        temp_settings[key] = value;
+    configEvent(deferEvents, EventCode::CONFIG_LOADING, 0, 0, 0, 0.0, filename.c_str());
+    parseConfigText(text, parsed, [&](const ConfigEntry& entry) {
+        char detail[128];
+        switch (entry.issue) {
+            case ConfigIssue::NONE:
+            case ConfigIssue::BAD_NUMBER:
+            case ConfigIssue::OUT_OF_RANGE:
+                if (deferEvents || events.wants(eventSeverity(EventCode::CONFIG_VALUE))) {
+                    std::snprintf(detail, sizeof(detail), "%.*s = %.*s",
+                                  static_cast<int>(entry.key.size()), entry.key.data(),
+                                  static_cast<int>(entry.value.size()), entry.value.data());
+                    configEvent(deferEvents, EventCode::CONFIG_VALUE, 0, 0, 0, 0.0, detail);
+                }
+                if (entry.issue != ConfigIssue::NONE) {
+                    invalidValues++;
+                    // Schema keys are string literals, so key.data() is terminated
+                    configEvent(deferEvents, EventCode::CONFIG_VALUE_INVALID, static_cast<int>(entry.line), 0, 0,
+                                configFieldValue(*entry.field, parsed), entry.field->key.data());
+                }
+                break;
+            case ConfigIssue::MALFORMED_LINE:
+            case ConfigIssue::UNKNOWN_KEY:
+                std::snprintf(detail, sizeof(detail), "%.*s", static_cast<int>(entry.key.size()), entry.key.data());
+                configEvent(deferEvents, EventCode::CONFIG_LINE_IGNORED, static_cast<int>(entry.line), 0, 0, 0.0,
+                            detail);
+                break;
+        }
+    });
+    return true;
+}
+
+/**
+ * @brief Loads the configuration file and initializes the sensors from it
+ *
+ * Missing keys and invalid values keep their current settings. The first
+ * load after counters were restored from a checkpoint keeps the restored
+ * roll instead of assuming a fresh one.
+ */
+void LabelingMachine::loadConfig(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    MachineConfig parsed = currentConfig();
+    int invalidValues = 0;
+    const bool loaded = parseConfig(filename, parsed, invalidValues, false);
+    if (!loaded) {
+        emitEvent(EventCode::CONFIG_DEFAULTS);
+    }
+    publishConfig(parsed);
+    if (!countersRestored) {
+        setRoll(parsed.initialLabelCount);  // Initialize sensor value
     }
-    infile.close();
-    for (const auto& pair : temp_settings) {
-        std::cout << "[INFO] Loaded config: " << pair.first << " = " << pair.second << "\n";
-        if(pair.first == "defaultSpeed") {
-            int val = std::stoi(pair.second);
-            config.defaultSpeed = val;
-        } 
-        else if(pair.first == "maxSpeed") {
-            int val = std::stoi(pair.second);
-            if(val >= 0 && val <= 500) { // Arbitrary upper limit
-                config.maxSpeed = val;
-            } else {
-                std::cout << "[WARNING] Invalid maxSpeed value in config. Using default: " 
-                          << config.maxSpeed << "\n";
-            }
-        } 
-        else if(pair.first == "minSpeed") {
-            int val = std::stoi(pair.second);
-            if(val >= 10 && val <= 200) { // Arbitrary lower limit
-                config.minSpeed = val;
-            } else {
-                std::cout << "[WARNING] Invalid minSpeed value in config. Using default: " 
-                          << config.minSpeed << "\n";
-            }
-        } 
-        else if(pair.first == "maintenanceSpeed") {
-            int val = std::stoi(pair.second);
-            if(val >= 5 && val <= 1000) { // Arbitrary limits
-                config.maintenanceSpeed = val;
-            } else {
-                std::cout << "[WARNING] Invalid maintenanceSpeed value in config. Using default: " 
-                          << config.maintenanceSpeed << "\n";
-            }
-        } 
-        else if(pair.first == "initialLabelCount") {
-            int val = std::stoi(pair.second);
-            if(val >= 0 && val <= 10000) { // Arbitrary upper limit
-                config.initialLabelCount = val;
-                sensors.labelRollRemaining = val; // Initialize sensor value
-            } else {
-                std::cout << "[WARNING] Invalid initialLabelCount value in config. Using default: " 
-                          << config.initialLabelCount << "\n";
-            }
-        } 
-        else if(pair.first == "lowLabelThreshold") {
-            int val = std::stoi(pair.second);
-            if(val >= 0 && val <= 500) { // Arbitrary upper limit
-                config.lowLabelThreshold = val;
-            } else {
-                std::cout << "[WARNING] Invalid lowLabelThreshold value in config. Using default: " 
-                          << config.lowLabelThreshold << "\n";
-            }
-        }   
-        else if(pair.first == "nominalTemperature") {
-            double val = std::stod(pair.second);
-            if(val >= 0.0 && val <= 100.0) { // Arbitrary limits
-                config.nominalTemperature = val;
-            } else {
-                std::cout << "[WARNING] Invalid nominalTemperature value in config. Using default: " 
-                        << config.nominalTemperature << "\n";
-            }
-        } 
-        else if(pair.first == "maxTemperature") {
-            double val = std::stod(pair.second);
-            if(val >= 20.0 && val <= 150.0) { // Arbitrary limits
-                config.maxTemperature = val;
-            } else {
-                std::cout << "[WARNING] Invalid maxTemperature value in config. Using default: " 
-                          << config.maxTemperature << "\n";
-            }
-        }           
+    countersRestored = false;   // The roll from the checkpoint is still on the machine
+    sensors.temperature = parsed.nominalTemperature; // Initialize sensor value
+    updateIdealRate();
+    publishStatus();
+    if (loaded) {
+        emitEvent(EventCode::CONFIG_COMPLETE);
     }
-    infile.close(); 
-    sensors.labelRollRemaining = config.initialLabelCount; // Initialize sensor value
-    sensors.temperature = config.nominalTemperature; // Initialize sensor value
-    std::cout << "[INFO] Configuration loading complete.\n";
-}   
+}
+
+bool LabelingMachine::reloadConfig(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    const MachineConfig& current = currentConfig();
+    MachineConfig parsed = current;
+    int invalidValues = 0;
+    if (!parseConfig(filename, parsed, invalidValues, true)) {
+        configEvent(true, EventCode::CONFIG_RELOAD_REJECTED, 0, 0, 0, 0.0, "file missing");
+        return false;
+    }
+    if (invalidValues > 0) {
+        configEvent(true, EventCode::CONFIG_RELOAD_REJECTED, invalidValues, 0, 0, 0.0, "invalid values");
+        return false;
+    }
+    if (parsed.minSpeed > parsed.maxSpeed) {
+        configEvent(true, EventCode::CONFIG_RELOAD_REJECTED, parsed.minSpeed, parsed.maxSpeed, 0, 0.0,
+                    "minSpeed above maxSpeed");
+        return false;
+    }
+
+    // Settings that only take effect through loadConfig() keep their values
+    MachineConfig next = current;
+    next.defaultSpeed = parsed.defaultSpeed;
+    next.minSpeed = parsed.minSpeed;
+    next.maxSpeed = parsed.maxSpeed;
+    next.maintenanceSpeed = parsed.maintenanceSpeed;
+    next.lowLabelThreshold = parsed.lowLabelThreshold;
+    next.maxTemperature = parsed.maxTemperature;
+    next.rollWarningLead = parsed.rollWarningLead;
+    next.rampAcceleration = parsed.rampAcceleration;
+    next.rampJerk = parsed.rampJerk;
+    publishConfig(next);
+    configEvent(true, EventCode::CONFIG_RELOADED, 0, 0, 0, 0.0, filename.c_str());
+    return true;
+}
+
+bool LabelingMachine::watchConfig(const std::string& filename) {
+    unwatchConfig();
+    std::unique_ptr<ConfigWatcher> watcher(new ConfigWatcher(filename, [this, filename]() {
+        reloadConfig(filename);
+    }));
+    if (!watcher->isWatching()) {
+        emitEvent(EventCode::CONFIG_WATCH_FAILED, 0, 0, 0, 0.0, filename.c_str());
+        return false;
+    }
+    configWatcher = std::move(watcher);
+    emitEvent(EventCode::CONFIG_WATCHING, 0, 0, 0, 0.0, filename.c_str());
+    return true;
+}
+
+void LabelingMachine::unwatchConfig() {
+    // Joins the watcher thread, so no reload is running afterwards
+    configWatcher.reset();
+}
@@ -0,0 +1,93 @@
+#include "labelm_configschema.h"
+
+#include <charconv>
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    const char* blanks = " \t\r";
+    const std::size_t first = text.find_first_not_of(blanks);
+    if (first == std::string_view::npos) {
+        return std::string_view();
+    }
+    return text.substr(first, text.find_last_not_of(blanks) - first + 1);
+}
+
+/**
+ * @brief Parses the whole of text as a number
+ * @return false if text is empty, has trailing characters or overflows
+ */
+template <typename T>
+bool parseNumber(std::string_view text, T& value) {
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);  // std::from_chars does not accept a plus sign
+    }
+    const char* end = text.data() + text.size();
+    const std::from_chars_result result = std::from_chars(text.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+/**
+ * @brief Validates value against field and stores it in config
+ */
+ConfigIssue applyValue(const ConfigField& field, std::string_view value, MachineConfig& config) {
+    if (field.type == ConfigValueType::INT) {
+        int number;
+        if (!parseNumber(value, number)) {
+            return ConfigIssue::BAD_NUMBER;
+        }
+        if (number < field.minValue || number > field.maxValue) {
+            return ConfigIssue::OUT_OF_RANGE;
+        }
+        config.*field.intMember = number;
+    } else {
+        double number;
+        if (!parseNumber(value, number)) {
+            return ConfigIssue::BAD_NUMBER;
+        }
+        if (!(number >= field.minValue && number <= field.maxValue)) {     // Also rejects NaN
+            return ConfigIssue::OUT_OF_RANGE;
+        }
+        config.*field.doubleMember = number;
+    }
+    return ConfigIssue::NONE;
+}
+
+} // namespace
+
+std::size_t parseConfigText(std::string_view text, MachineConfig& config,
+                            const std::function<void(const ConfigEntry&)>& visit) {
+    std::size_t issues = 0;
+    std::size_t lineNumber = 0;
+    while (!text.empty()) {
+        const std::size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+        lineNumber++;
+
+        // Skip comments and empty lines
+        line = trim(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        ConfigEntry entry = {lineNumber, line, std::string_view(), nullptr, ConfigIssue::NONE};
+        const std::size_t equals = line.find('=');
+        if (equals == std::string_view::npos) {
+            entry.issue = ConfigIssue::MALFORMED_LINE;
+        } else {
+            entry.key = trim(line.substr(0, equals));
+            entry.value = trim(line.substr(equals + 1));
+            entry.field = findConfigField(entry.key);
+            entry.issue = entry.field != nullptr ? applyValue(*entry.field, entry.value, config)
+                                                 : ConfigIssue::UNKNOWN_KEY;
+        }
+        if (entry.issue != ConfigIssue::NONE) {
+            issues++;
+        }
+        if (visit) {
+            visit(entry);
+        }
+    }
+    return issues;
+}
@@ -0,0 +1,78 @@
+#include "labelm_configwatch.h"
+
+#include <cstring>
+#include <utility>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+
+/// Poll timeout while waiting for events; bounds the shutdown latency
+constexpr int IDLE_POLL_MS = 100;
+
+} // namespace
+
+ConfigWatcher::ConfigWatcher(const std::string& path, std::function<void()> onChange,
+                             std::chrono::milliseconds settle)
+    : onChange(std::move(onChange))
+    , settle(settle)
+{
+    const std::size_t slash = path.find_last_of('/');
+    directory = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+    name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        return;
+    }
+    if (::inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        ::close(inotifyFd);
+        inotifyFd = -1;
+        return;
+    }
+    worker = std::thread(&ConfigWatcher::run, this);
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stopping.store(true, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (inotifyFd >= 0) {
+        ::close(inotifyFd);
+    }
+}
+
+void ConfigWatcher::run() {
+    alignas(inotify_event) char buffer[4096];
+    bool pending = false;
+    while (!stopping.load(std::memory_order_acquire)) {
+        pollfd descriptor = {inotifyFd, POLLIN, 0};
+        const int timeout = pending ? static_cast<int>(settle.count()) : IDLE_POLL_MS;
+        const int ready = ::poll(&descriptor, 1, timeout);
+        if (ready == 0) {
+            if (pending) {
+                // Quiet for the settle time: the write is complete
+                pending = false;
+                onChange();
+            }
+            continue;
+        }
+        if (ready < 0) {
+            continue;   // EINTR
+        }
+
+        ssize_t length;
+        while ((length = ::read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+                if (event->len > 0 && std::strcmp(event->name, name.c_str()) == 0) {
+                    pending = true;
+                }
+                cursor += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
@@ -0,0 +1,311 @@
+#include "labelm_events.h"
+
+#include <cstdio>
+#include <iostream>
+
+std::size_t formatEvent(const StatusEvent& event, char* buffer, std::size_t size) {
+    const char* detail = event.detail != nullptr ? event.detail : "";
+    int length = 0;
+
+    switch (event.code) {
+        case EventCode::MACHINE_INITIALIZED:
+            length = std::snprintf(buffer, size, "[SYSTEM] Machine initialized: %s (Firmware: %s)",
+                                   event.machineId, detail);
+            break;
+        case EventCode::MACHINE_SHUTDOWN:
+            length = std::snprintf(buffer, size, "[SYSTEM] Machine shutdown complete");
+            break;
+        case EventCode::STARTED:
+            length = std::snprintf(buffer, size, "[INFO] Machine started - Speed: %d mm/s", event.value1);
+            break;
+        case EventCode::START_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot start machine - not in IDLE state");
+            break;
+        case EventCode::START_OVER_TEMPERATURE:
+        case EventCode::RESUME_OVER_TEMPERATURE:
+            length = std::snprintf(buffer, size, "[ERROR] Cannot start - temperature too high: %.1f°C",
+                                   event.measurement);
+            break;
+        case EventCode::START_NO_LABELS:
+            length = std::snprintf(buffer, size, "[ERROR] Cannot start - no labels available");
+            break;
+        case EventCode::STOPPED:
+            length = std::snprintf(buffer, size, "[INFO] Machine stopped - Total labeled: %d", event.value1);
+            break;
+        case EventCode::PAUSED:
+            length = std::snprintf(buffer, size, "[INFO] Machine paused - Total labeled: %d - Remaining labels: %d",
+                                   event.value1, event.value2);
+            break;
+        case EventCode::PAUSE_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot pause machine - not in RUNNING state");
+            break;
+        case EventCode::RESUMED:
+            length = std::snprintf(buffer, size, "[INFO] Machine resumed - Speed: %d mm/s", event.value1);
+            break;
+        case EventCode::RESUME_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot resume machine - not in PAUSED state");
+            break;
+        case EventCode::RESUME_NO_LABELS:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot resume - no labels available. To IDLE state.");
+            break;
+        case EventCode::MAINTENANCE_ENTERED:
+            length = std::snprintf(buffer, size, "[INFO] Machine in maintenance.");
+            break;
+        case EventCode::MAINTENANCE_ENTER_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot enter maintenance machine - not in IDLE state");
+            break;
+        case EventCode::MAINTENANCE_EXITED:
+            length = std::snprintf(buffer, size, "[INFO] Machine exited from maintenance mode. Ready for operation.");
+            break;
+        case EventCode::MAINTENANCE_EXIT_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot exit maintenance mode - not in MAINTENANCE state");
+            break;
+        case EventCode::PRODUCT_DETECTED:
+            length = std::snprintf(buffer, size, "[SENSOR] Product detected at labeling position");
+            break;
+        case EventCode::LABEL_APPLIED:
+            length = std::snprintf(buffer, size, "[PRODUCTION] Label applied - Product #%d | Labels remaining: %d",
+                                   event.value1, event.value2);
+            break;
+        case EventCode::LABEL_FAILED:
+            length = std::snprintf(buffer, size, "[ERROR] Label application failed - Roll empty!");
+            break;
+        case EventCode::LOW_LABEL_WARNING:
+            length = std::snprintf(buffer, size, "[WARNING] Low label warning - Labels remaining: %d", event.value1);
+            break;
+        case EventCode::LOW_LABEL_CLEARED:
+            length = std::snprintf(buffer, size, "[INFO] Low Label Warning cleared - machine is running");
+            break;
+        case EventCode::SPEED_CHANGED:
+            length = std::snprintf(buffer, size, "[INFO] Speed changed to %d mm/s", event.value1);
+            break;
+        case EventCode::SPEED_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot adjust speed - machine not running");
+            break;
+        case EventCode::SPEED_INVALID:
+            length = std::snprintf(buffer, size, "[ERROR] Invalid speed: %d mm/s (valid range: %d-%d)",
+                                   event.value1, event.value2, event.value3);
+            break;
+        case EventCode::COUNTERS_RESET:
+            length = std::snprintf(buffer, size, "[INFO] Production counters reset");
+            break;
+        case EventCode::COUNTERS_RESET_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot reset counters while machine is operating");
+            break;
+        case EventCode::ROLL_LOADED:
+            length = std::snprintf(buffer, size, "[INFO] Label roll loaded: %d labels", event.value1);
+            break;
+        case EventCode::ROLL_INVALID:
+            length = std::snprintf(buffer, size, "[ERROR] Invalid label count");
+            break;
+        case EventCode::ERROR_CLEARED:
+            length = std::snprintf(buffer, size, "[INFO] Error cleared - machine ready");
+            break;
+        case EventCode::LOG_OPENED:
+            length = std::snprintf(buffer, size, "[INFO] Log file initialized and header written on: %s", detail);
+            break;
+        case EventCode::LOG_OPEN_FAILED:
+            length = std::snprintf(buffer, size, "[ERROR] Failed to open log file: %s", detail);
+            break;
+        case EventCode::LOG_NOT_OPEN:
+            length = std::snprintf(buffer, size, "[ERROR] Log file not open. Cannot log entry.");
+            break;
+        case EventCode::LOG_CLOSED:
+            length = std::snprintf(buffer, size, "\n[INFO] Closing product log (%s)\n Total products logged: %d",
+                                   detail, event.value1);
+            break;
+        case EventCode::LOG_REPLAYED:
+            length = std::snprintf(buffer, size, "[INFO] Restored from %s: %d rows, %d products labeled, %d errors",
+                                   detail, event.value1, event.value2, event.value3);
+            break;
+        case EventCode::LOG_REPLAY_FAILED:
+            length = std::snprintf(buffer, size, "[WARNING] Log replay failed: %s", detail);
+            break;
+        case EventCode::CONFIG_FILE_MISSING:
+            length = std::snprintf(buffer, size, "[WARNING] Configuration file not found or cannot be opened: %s",
+                                   detail);
+            break;
+        case EventCode::CONFIG_DEFAULTS:
+            length = std::snprintf(buffer, size, "[INFO] Using default settings.");
+            break;
+        case EventCode::CONFIG_LOADING:
+            length = std::snprintf(buffer, size, "[INFO] Loading configuration from %s", detail);
+            break;
+        case EventCode::CONFIG_VALUE:
+            length = std::snprintf(buffer, size, "[INFO] Loaded config: %s", detail);
+            break;
+        case EventCode::CONFIG_VALUE_INVALID:
+            length = std::snprintf(buffer, size, "[WARNING] Invalid %s value in config. Using default: %g",
+                                   detail, event.measurement);
+            break;
+        case EventCode::CONFIG_LINE_IGNORED:
+            length = std::snprintf(buffer, size, "[WARNING] Ignoring unknown setting or malformed line %d in config: %s",
+                                   event.value1, detail);
+            break;
+        case EventCode::CONFIG_COMPLETE:
+            length = std::snprintf(buffer, size, "[INFO] Configuration loading complete.");
+            break;
+        case EventCode::CONFIG_RELOADED:
+            length = std::snprintf(buffer, size, "[INFO] Configuration reloaded from %s", detail);
+            break;
+        case EventCode::CONFIG_RELOAD_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Configuration reload rejected (%s). Keeping current settings.",
+                                   detail);
+            break;
+        case EventCode::CONFIG_WATCHING:
+            length = std::snprintf(buffer, size, "[INFO] Watching %s for configuration changes", detail);
+            break;
+        case EventCode::CONFIG_WATCH_FAILED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot watch %s for configuration changes", detail);
+            break;
+        case EventCode::STATUS_BLOCK_OPENED:
+            length = std::snprintf(buffer, size, "[INFO] Publishing live status in shared memory %s", detail);
+            break;
+        case EventCode::STATUS_BLOCK_FAILED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot create shared-memory status block %s", detail);
+            break;
+        case EventCode::METRICS_SERVING:
+            length = std::snprintf(buffer, size, "[INFO] Serving metrics on http://127.0.0.1:%d/metrics", event.value1);
+            break;
+        case EventCode::METRICS_FAILED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot serve metrics on port %d", event.value1);
+            break;
+        case EventCode::LATENCY_SUMMARY:
+            length = std::snprintf(buffer, size, "[INFO] Latency %s: p50 %.2f us, p99 %.2f us, p99.9 %.2f us, max %.2f us",
+                                   detail, event.value1 / 1000.0, event.value2 / 1000.0, event.value3 / 1000.0,
+                                   event.measurement / 1000.0);
+            break;
+        case EventCode::TRACE_WRITTEN:
+            length = std::snprintf(buffer, size, "[INFO] Trace written to %s (%d events, %d dropped)",
+                                   detail, event.value1, event.value2);
+            break;
+        case EventCode::TRACE_WRITE_FAILED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot write trace %s", detail);
+            break;
+        case EventCode::COUNTERS_RESTORED:
+            length = std::snprintf(buffer, size, "[INFO] Counters restored from %s: %d labeled, %d errors, %d labels on roll",
+                                   detail, event.value1, event.value2, event.value3);
+            break;
+        case EventCode::CHECKPOINT_FAILED:
+            length = std::snprintf(buffer, size, "[WARNING] Cannot open counter checkpoint %s; counters will not persist",
+                                   detail);
+            break;
+        case EventCode::BATCH_STARTED:
+            length = std::snprintf(buffer, size, "[INFO] Batch %s started: %d products (%d orders queued)",
+                                   detail, event.value1, event.value2);
+            break;
+        case EventCode::BATCH_COMPLETED:
+            length = std::snprintf(buffer, size, "[INFO] Batch %s completed: %d products labeled", detail, event.value1);
+            break;
+        case EventCode::BATCH_CANCELLED:
+            length = std::snprintf(buffer, size, "[INFO] Batch %s cancelled after %d of %d products",
+                                   detail, event.value1, event.value2);
+            break;
+        case EventCode::BATCH_REJECTED:
+            length = std::snprintf(buffer, size, "[WARNING] Batch rejected (%s).", detail);
+            break;
+        case EventCode::WORK_ORDER_QUEUED:
+            length = std::snprintf(buffer, size, "[INFO] Work order %s queued: %d products (%d orders queued)",
+                                   detail, event.value1, event.value2);
+            break;
+        case EventCode::ROLL_CHANGE_STAGED:
+            length = std::snprintf(buffer, size, "[INFO] Stage a %d-label roll for batch %s: changeover in %d products",
+                                   event.value1, detail, event.value2);
+            break;
+        case EventCode::BATCH_QUEUE_EMPTY:
+            length = std::snprintf(buffer, size, "[INFO] No work orders queued");
+            break;
+        case EventCode::ROLL_CHANGE_DUE:
+            length = std::snprintf(buffer, size,
+                                   "[WARNING] Label roll forecast to run out in %d s (%d labels at %.1f labels/min). Schedule a roll change.",
+                                   event.value1, event.value2, event.measurement);
+            break;
+        case EventCode::SPEED_RAMP_STARTED:
+            length = std::snprintf(buffer, size, "[INFO] Ramping speed from %d to %d mm/s (%s, %.1f s)",
+                                   event.value1, event.value2, event.value3 == 0 ? "trapezoidal" : "S-curve",
+                                   event.measurement);
+            break;
+        case EventCode::SPEED_RAMP_COMPLETE:
+            length = std::snprintf(buffer, size, "[INFO] Speed ramp complete at %d mm/s", event.value1);
+            break;
+        case EventCode::SPEED_RAMP_CANCELLED:
+            length = std::snprintf(buffer, size, "[INFO] Speed ramp cancelled at %d mm/s (target %d mm/s)",
+                                   event.value1, event.value2);
+            break;
+        case EventCode::COUNT:
+            break;
+    }
+
+    if (length <= 0 || static_cast<std::size_t>(length) >= size) {
+        return 0;
+    }
+    return static_cast<std::size_t>(length);
+}
+
+void ConsoleEventSink::consume(const StatusEvent& event) {
+    char line[256];
+    std::size_t length = formatEvent(event, line, sizeof(line));
+    if (length == 0) {
+        return;
+    }
+    line[length++] = '\n';
+    // Log file problems have always been reported on stderr
+    std::ostream& out = (event.code == EventCode::LOG_OPEN_FAILED || event.code == EventCode::LOG_NOT_OPEN)
+                        ? std::cerr : std::cout;
+    out.write(line, static_cast<std::streamsize>(length));
+}
+
+RingBufferEventSink::RingBufferEventSink(std::size_t capacity)
+    : ring(capacity)
+{
+}
+
+void RingBufferEventSink::consume(const StatusEvent& event) {
+    StatusEvent copy = event;
+    copy.detail = nullptr; // Not valid once dispatch returns
+    if (!ring.tryPush(copy)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool RingBufferEventSink::poll(StatusEvent& event) {
+    return ring.tryPop(event);
+}
+
+std::uint64_t RingBufferEventSink::dropped() const {
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+CallbackEventSink::CallbackEventSink(std::function<void(const StatusEvent&)> callback)
+    : callback(std::move(callback))
+{
+}
+
+void CallbackEventSink::consume(const StatusEvent& event) {
+    if (callback) {
+        callback(event);
+    }
+}
+
+void EventDispatcher::addSink(std::shared_ptr<EventSink> sink, EventSeverity minSeverity) {
+    if (!sink) {
+        return;
+    }
+    sinks.push_back(Entry{std::move(sink), minSeverity});
+    if (minSeverity < threshold) {
+        threshold = minSeverity;
+    }
+}
+
+void EventDispatcher::clear() {
+    sinks.clear();
+    threshold = EventSeverity::OFF;
+}
+
+void EventDispatcher::dispatch(const StatusEvent& event) const {
+    for (const Entry& entry : sinks) {
+        if (event.severity >= entry.minSeverity) {
+            entry.sink->consume(event);
+        }
+    }
+}
@@ -0,0 +1,287 @@
+#include "labelm_fleet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+std::int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Prefixes the file name of a path with the machine id (`dir/<id>_name`)
+ */
+std::string linePath(const std::string& path, const std::string& machineId) {
+    std::size_t slash = path.find_last_of('/');
+    std::size_t nameStart = slash == std::string::npos ? 0 : slash + 1;
+    return path.substr(0, nameStart) + machineId + "_" + path.substr(nameStart);
+}
+
+/**
+ * @brief Log file of one line: the default (or template) file name prefixed with the machine id
+ */
+std::string lineLogPath(const LogOptions& log, const std::string& machineId) {
+    std::string path = log.path;
+    if (path.empty()) {
+        switch (log.format) {
+            case LogFormat::CSV:            path = LOG_FILE_NAME; break;
+            case LogFormat::BINARY_JOURNAL: path = JOURNAL_FILE_NAME; break;
+            case LogFormat::MAPPED_RING:    path = RING_LOG_FILE_NAME; break;
+            case LogFormat::DISABLED:       return path;
+        }
+    }
+    return linePath(path, machineId);
+}
+
+std::size_t bucketFor(std::uint64_t ns, std::size_t bucketCount) {
+    std::size_t bucket = 0;
+    while (ns > 1 && bucket + 1 < bucketCount) {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void pinToCpu(std::thread& thread, std::size_t cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<int>(cpu), &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+} // namespace
+
+FleetController::Line::Line(const MachineOptions& options, std::size_t queueCapacity)
+    : machine(new LabelingMachine(options))
+    , queue(queueCapacity)
+{
+}
+
+FleetController::FleetController(const FleetOptions& options)
+    : options(options)
+{
+    for (std::size_t i = 0; i < options.lineCount; i++) {
+        char id[32];
+        std::snprintf(id, sizeof(id), "LM3000-%03zu", i + 1);
+        MachineOptions machineOptions = options.machine;
+        machineOptions.machineId = id;
+        machineOptions.log.path = lineLogPath(options.machine.log, id);
+        if (!options.machine.checkpointPath.empty()) {
+            // One checkpoint per machine: a shared file would mix the counters of all lines
+            machineOptions.checkpointPath = linePath(options.machine.checkpointPath, id);
+        }
+        lines.emplace_back(new Line(machineOptions, options.queueCapacity));
+        // Also initialises the label roll and temperature when the file is missing
+        lines.back()->machine->loadConfig(options.configFile);
+    }
+
+    std::size_t hardware = std::thread::hardware_concurrency();
+    workerTotal = options.workerThreads > 0 ? options.workerThreads : (hardware > 0 ? hardware : 1);
+    if (workerTotal > lines.size()) {
+        workerTotal = lines.size() > 0 ? lines.size() : 1;
+    }
+}
+
+FleetController::~FleetController() {
+    stop();
+}
+
+bool FleetController::start() {
+    if (running.exchange(true)) {
+        return false;
+    }
+    startedNs.store(steadyNowNs());
+    stoppedNs.store(0);
+
+    // Machines are started on their own worker thread (first queued command)
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        postCommand(i, LineCommandType::START);
+    }
+
+    const std::size_t cpus = std::thread::hardware_concurrency();
+    for (std::size_t w = 0; w < workerTotal; w++) {
+        workers.emplace_back(&FleetController::runWorker, this, w);
+        if (options.pinThreads && cpus > 0) {
+            pinToCpu(workers.back(), w % cpus);
+        }
+    }
+    return true;
+}
+
+void FleetController::stop() {
+    if (!running.load()) {
+        return;
+    }
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        while (!postCommand(i, LineCommandType::STOP)) {
+            std::this_thread::yield();
+        }
+    }
+    running.store(false, std::memory_order_release);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    stoppedNs.store(steadyNowNs());
+}
+
+bool FleetController::postCommand(std::size_t line, LineCommandType type, std::int32_t value) {
+    if (line >= lines.size()) {
+        return false;
+    }
+    LineCommand command;
+    command.type = type;
+    command.value = value;
+    command.enqueuedNs = steadyNowNs();
+    if (!lines[line]->queue.tryPush(command)) {
+        lines[line]->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Worker thread: drains the queues of lines worker, worker + W, ...
+ *
+ * Commands are processed in batches per line; the loop only backs off
+ * (yield, then short sleep) when all of its queues were empty. Queued
+ * commands are drained completely before the worker exits.
+ */
+void FleetController::runWorker(std::size_t worker) {
+    static constexpr std::size_t BATCH = 64;
+    std::size_t idleRounds = 0;
+    for (;;) {
+        const bool stopping = !running.load(std::memory_order_acquire);
+        bool didWork = false;
+        for (std::size_t i = worker; i < lines.size(); i += workerTotal) {
+            Line& line = *lines[i];
+            LineCommand command;
+            for (std::size_t n = 0; n < BATCH && line.queue.tryPop(command); n++) {
+                execute(line, command);
+                didWork = true;
+            }
+        }
+        if (didWork) {
+            idleRounds = 0;
+            continue;
+        }
+        if (stopping) {
+            break;
+        }
+        if (++idleRounds < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+void FleetController::execute(Line& line, const LineCommand& command) {
+    LabelingMachine& machine = *line.machine;
+    switch (command.type) {
+        case LineCommandType::PRODUCT_DETECTED: machine.detectProduct(true); break;
+        case LineCommandType::PRODUCT_CLEARED:  machine.detectProduct(false); break;
+        case LineCommandType::LOAD_LABEL_ROLL:  machine.loadLabelRoll(command.value); break;
+        case LineCommandType::START:            machine.start(); break;
+        case LineCommandType::STOP:             machine.stop(); break;
+        case LineCommandType::PAUSE:            machine.pause(); break;
+        case LineCommandType::RESUME:           machine.resume(); break;
+    }
+
+    const std::uint64_t latency = static_cast<std::uint64_t>(steadyNowNs() - command.enqueuedNs);
+    line.processed.fetch_add(1, std::memory_order_relaxed);
+    line.labeled.store(machine.getProductionCount(), std::memory_order_relaxed);
+    const RollForecast forecast = machine.getRollForecast();
+    line.labelsRemaining.store(forecast.labelsRemaining, std::memory_order_relaxed);
+    line.secondsToEmpty.store(forecast.secondsToEmpty, std::memory_order_relaxed);
+    line.latencySumNs.fetch_add(latency, std::memory_order_relaxed);
+    if (latency > line.latencyMaxNs.load(std::memory_order_relaxed)) {
+        line.latencyMaxNs.store(latency, std::memory_order_relaxed);
+    }
+    line.latencyBuckets[bucketFor(latency, LATENCY_BUCKETS)].fetch_add(1, std::memory_order_relaxed);
+}
+
+LineStats FleetController::lineStats(std::size_t index) const {
+    LineStats result;
+    if (index >= lines.size()) {
+        return result;
+    }
+    const Line& line = *lines[index];
+    result.machineId = line.machine->getMachineId();
+    result.commandsProcessed = line.processed.load(std::memory_order_relaxed);
+    result.commandsDropped = line.dropped.load(std::memory_order_relaxed);
+    result.productsLabeled = line.labeled.load(std::memory_order_relaxed);
+    result.maxLatencyUs = line.latencyMaxNs.load(std::memory_order_relaxed) / 1000.0;
+    result.labelRollRemaining = line.labelsRemaining.load(std::memory_order_relaxed);
+    result.secondsToEmpty = line.secondsToEmpty.load(std::memory_order_relaxed);
+
+    std::uint64_t counts[LATENCY_BUCKETS];
+    std::uint64_t total = 0;
+    for (std::size_t b = 0; b < LATENCY_BUCKETS; b++) {
+        counts[b] = line.latencyBuckets[b].load(std::memory_order_relaxed);
+        total += counts[b];
+    }
+    if (total > 0) {
+        result.meanLatencyUs = line.latencySumNs.load(std::memory_order_relaxed) / 1000.0 / total;
+        const std::uint64_t rank = total - total / 100;
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < LATENCY_BUCKETS; b++) {
+            seen += counts[b];
+            if (seen >= rank) {
+                result.p99LatencyUs = static_cast<double>(std::uint64_t(2) << b) / 1000.0;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<RollChangeDue> FleetController::rollChangeSchedule(std::chrono::seconds horizon) const {
+    std::vector<RollChangeDue> due;
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        const Line& line = *lines[i];
+        const double seconds = line.secondsToEmpty.load(std::memory_order_relaxed);
+        if (seconds >= 0.0 && seconds <= static_cast<double>(horizon.count())) {
+            due.push_back(RollChangeDue{i, line.machine->getMachineId(),
+                                        line.labelsRemaining.load(std::memory_order_relaxed), seconds});
+        }
+    }
+    std::sort(due.begin(), due.end(), [](const RollChangeDue& a, const RollChangeDue& b) {
+        return a.secondsToEmpty < b.secondsToEmpty;
+    });
+    return due;
+}
+
+FleetStats FleetController::stats() const {
+    FleetStats result;
+    result.lines = lines.size();
+    result.workers = workerTotal;
+    const std::int64_t started = startedNs.load();
+    if (started != 0) {
+        const std::int64_t stopped = stoppedNs.load();
+        const std::int64_t end = stopped != 0 ? stopped : steadyNowNs();
+        result.elapsedSeconds = (end - started) / 1e9;
+    }
+    for (const std::unique_ptr<Line>& line : lines) {
+        result.commandsProcessed += line->processed.load(std::memory_order_relaxed);
+        result.productsLabeled += static_cast<std::uint64_t>(line->labeled.load(std::memory_order_relaxed));
+    }
+    if (result.elapsedSeconds > 0.0) {
+        result.commandsPerSecond = result.commandsProcessed / result.elapsedSeconds;
+        result.labelsPerSecond = result.productsLabeled / result.elapsedSeconds;
+    }
+    return result;
+}
@@ -0,0 +1,13 @@
+#include "labelm_forecast.h"
+
+RollForecast RollForecaster::forecast(int labelsRemaining, std::int64_t nowNs) const {
+    RollForecast result;
+    result.labelsRemaining = labelsRemaining;
+    if (!isReady()) {
+        return result;
+    }
+    result.labelsPerMinute = labelsPerMinute();
+    result.secondsToEmpty = secondsToEmpty(labelsRemaining);
+    result.emptyAtNs = nowNs + static_cast<std::int64_t>(labelsRemaining * averageIntervalNs);
+    return result;
+}
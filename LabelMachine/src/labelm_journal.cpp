@@ -0,0 +1,124 @@
+#include "labelm_journal.h"
+
+#include <cmath>
+#include <cstring>
+
+JournalRecord encodeJournalRecord(const LogRecord& record) {
+    JournalRecord out;
+    out.timestampNs = record.timestampNs;
+    out.productId = record.productId;
+
+    long deci = std::lround(record.temperature * 10.0);
+    if (deci > INT16_MAX) deci = INT16_MAX;
+    if (deci < INT16_MIN) deci = INT16_MIN;
+    out.temperatureDeci = static_cast<std::int16_t>(deci);
+
+    std::uint16_t speed = static_cast<std::uint16_t>(
+        record.conveyorSpeed < 0 ? 0 : (record.conveyorSpeed > 0x0FFF ? 0x0FFF : record.conveyorSpeed));
+    out.packed = static_cast<std::uint16_t>(speed
+        | (static_cast<std::uint16_t>(record.status) & 0x1) << 12
+        | (static_cast<std::uint16_t>(record.state) & 0x7) << 13);
+    return out;
+}
+
+LogRecord decodeJournalRecord(const JournalRecord& record) {
+    LogRecord out;
+    out.timestampNs = record.timestampNs;
+    out.productId = record.productId;
+    out.temperature = record.temperatureDeci / 10.0;
+    out.conveyorSpeed = record.packed & 0x0FFF;
+    out.status = static_cast<LogStatus>((record.packed >> 12) & 0x1);
+    out.state = static_cast<MachineState>((record.packed >> 13) & 0x7);
+    return out;
+}
+
+BinaryJournalSink::BinaryJournalSink(const std::string& path, std::size_t bufferRecords)
+    : file(path, std::ios::out | std::ios::binary | std::ios::trunc)
+    , buffer(bufferRecords > 0 ? bufferRecords : 1)
+{
+    if (file) {
+        JournalHeader header;
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = JOURNAL_VERSION;
+        header.recordSize = sizeof(JournalRecord);
+        header.reserved = 0;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.flush();
+    }
+}
+
+BinaryJournalSink::~BinaryJournalSink() {
+    flush();
+}
+
+bool BinaryJournalSink::isOpen() const {
+    return file.is_open() && file.good();
+}
+
+void BinaryJournalSink::write(const LogRecord& record) {
+    buffer[used++] = encodeJournalRecord(record);
+    written++;
+    if (used == buffer.size()) {
+        writeBuffer();
+    }
+}
+
+void BinaryJournalSink::writeBuffer() {
+    if (used > 0) {
+        file.write(reinterpret_cast<const char*>(buffer.data()),
+                   static_cast<std::streamsize>(used * sizeof(JournalRecord)));
+        used = 0;
+    }
+}
+
+void BinaryJournalSink::flush() {
+    writeBuffer();
+    file.flush();
+}
+
+LogWriterStats BinaryJournalSink::stats() const {
+    LogWriterStats result;
+    result.queued = written;
+    result.written = written;
+    return result;
+}
+
+bool readJournal(const std::string& path,
+                 const std::function<void(const LogRecord&)>& callback,
+                 std::string& error) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    JournalHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0) {
+        error = path + " is not a production journal";
+        return false;
+    }
+    if (header.version != JOURNAL_VERSION || header.recordSize != sizeof(JournalRecord)) {
+        error = path + " has unsupported journal version " + std::to_string(header.version);
+        return false;
+    }
+
+    // Large sequential blocks keep the scan limited by memory bandwidth
+    std::vector<JournalRecord> block(16384);
+    for (;;) {
+        in.read(reinterpret_cast<char*>(block.data()),
+                static_cast<std::streamsize>(block.size() * sizeof(JournalRecord)));
+        std::size_t count = static_cast<std::size_t>(in.gcount()) / sizeof(JournalRecord);
+        for (std::size_t i = 0; i < count; i++) {
+            callback(decodeJournalRecord(block[i]));
+        }
+        if (!in) {
+            break;
+        }
+    }
+    if (in.bad()) {
+        error = "read error on " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#include "labelm_latency.h"
+
+namespace {
+
+/// Index of the calling thread, assigned on its first recording
+std::size_t threadIndex() {
+    static std::atomic<std::size_t> nextIndex{0};
+    thread_local const std::size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+/**
+ * @brief Smallest bucket upper bound covering the given rank
+ */
+std::uint64_t percentileNs(const LatencySummary& summary, double fraction) {
+    if (summary.count == 0) {
+        return 0;
+    }
+    // Rank of the sample at this percentile (1-based, rounded up)
+    std::uint64_t rank = static_cast<std::uint64_t>(fraction * static_cast<double>(summary.count));
+    if (static_cast<double>(rank) < fraction * static_cast<double>(summary.count)) {
+        rank++;
+    }
+    rank = rank == 0 ? 1 : rank;
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+        seen += summary.buckets[bucket];
+        if (seen >= rank) {
+            const std::uint64_t upper = latencyBucketUpperNs(bucket);
+            return upper < summary.maxNs ? upper : summary.maxNs;
+        }
+    }
+    return summary.maxNs;
+}
+
+} // namespace
+
+const char* metricOperationName(MetricOperation operation) {
+    switch (operation) {
+        case MetricOperation::LABEL:          return "label";
+        case MetricOperation::START:          return "start";
+        case MetricOperation::STOP:           return "stop";
+        case MetricOperation::PAUSE:          return "pause";
+        case MetricOperation::RESUME:         return "resume";
+        case MetricOperation::SET_SPEED:      return "set_speed";
+        case MetricOperation::LOAD_ROLL:      return "load_roll";
+        case MetricOperation::ENTER_MAINTENANCE: return "enter_maintenance";
+        case MetricOperation::EXIT_MAINTENANCE:  return "exit_maintenance";
+        case MetricOperation::DETECT_PRODUCT: return "detect_product";
+        case MetricOperation::LOG_ENTRY:      return "log_entry";
+        case MetricOperation::TRANSITION:     return "transition";
+        case MetricOperation::COUNT:          break;
+    }
+    return "unknown";
+}
+
+LatencyRecorder::~LatencyRecorder() {
+    for (std::atomic<Shard*>& shard : shards) {
+        delete shard.load(std::memory_order_acquire);
+    }
+}
+
+LatencyRecorder::Shard& LatencyRecorder::shardOfThisThread() {
+    std::atomic<Shard*>& slot = shards[threadIndex() % SHARDS];
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard == nullptr) {
+        // First use of this shard; another thread may race us to it
+        Shard* fresh = new Shard();
+        if (slot.compare_exchange_strong(shard, fresh, std::memory_order_acq_rel)) {
+            shard = fresh;
+        } else {
+            delete fresh;
+        }
+    }
+    return *shard;
+}
+
+void LatencyRecorder::record(MetricOperation operation, std::uint64_t ns) {
+    Histogram& histogram = shardOfThisThread().operations[static_cast<std::size_t>(operation)];
+    histogram.buckets[latencyBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    histogram.sumNs.fetch_add(ns, std::memory_order_relaxed);
+    std::uint64_t max = histogram.maxNs.load(std::memory_order_relaxed);
+    while (ns > max && !histogram.maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+LatencySummary LatencyRecorder::summary(MetricOperation operation) const {
+    LatencySummary result;
+    for (const std::atomic<Shard*>& slot : shards) {
+        const Shard* shard = slot.load(std::memory_order_acquire);
+        if (shard == nullptr) {
+            continue;
+        }
+        const Histogram& histogram = shard->operations[static_cast<std::size_t>(operation)];
+        for (std::size_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+            const std::uint64_t count = histogram.buckets[bucket].load(std::memory_order_relaxed);
+            result.buckets[bucket] += count;
+            result.count += count;
+        }
+        result.sumNs += histogram.sumNs.load(std::memory_order_relaxed);
+        const std::uint64_t max = histogram.maxNs.load(std::memory_order_relaxed);
+        result.maxNs = max > result.maxNs ? max : result.maxNs;
+    }
+    if (result.count > 0) {
+        result.meanNs = static_cast<double>(result.sumNs) / static_cast<double>(result.count);
+        result.p50Ns = percentileNs(result, 0.50);
+        result.p99Ns = percentileNs(result, 0.99);
+        result.p999Ns = percentileNs(result, 0.999);
+    }
+    return result;
+}
@@ -0,0 +1,214 @@
+#include "labelm_logger.h"
+
+#include <cstdio>
+
+#include <pthread.h>
+
+#include "labelm_logindex.h"
+#include "labelm_trace.h"
+
+const char* logStatusName(LogStatus status) {
+    switch (status) {
+        case LogStatus::SUCCESS: return "SUCCESS";
+        case LogStatus::FAILURE: return "FAILURE";
+    }
+    return "UNKNOWN";
+}
+
+std::size_t formatCsvRow(const LogRecord& record, TimestampFormatter& formatter, char* buffer, std::size_t size) {
+    char timestamp[TimestampFormatter::BUFFER_SIZE];
+    formatter.format(record.timestampNs, timestamp, sizeof(timestamp));
+
+    int length = std::snprintf(buffer, size, "%s,%d,%.1f,%d,%s\n",
+                               timestamp, record.productId, record.temperature,
+                               record.conveyorSpeed, logStatusName(record.status));
+    if (length <= 0 || static_cast<std::size_t>(length) >= size) {
+        return 0;
+    }
+    return static_cast<std::size_t>(length);
+}
+
+CsvLogSink::CsvLogSink(const std::string& path, bool append, std::size_t indexInterval)
+    : file(path, std::ios::out | (append ? std::ios::app : std::ios::trunc))
+    , indexInterval(indexInterval)
+{
+    if (file && (!append || file.tellp() == std::streampos(0))) {
+        // Write the CSV header row
+        file << CSV_LOG_HEADER;
+        file.flush();
+    }
+    if (file) {
+        offset = static_cast<std::uint64_t>(file.tellp());
+        if (indexInterval > 0) {
+            index.reset(new LogIndexWriter(logIndexPath(path), static_cast<std::uint32_t>(indexInterval), append));
+        }
+    }
+}
+
+CsvLogSink::~CsvLogSink() {
+    flush();
+}
+
+bool CsvLogSink::isOpen() const {
+    return file.is_open() && file.good();
+}
+
+/**
+ * @brief Formats one record as a CSV row
+ *
+ * Runs on the logger thread when used behind AsyncLogWriter, so the
+ * formatting cost is kept off the labeling path.
+ */
+void CsvLogSink::write(const LogRecord& record) {
+    char row[128];
+    std::size_t length = formatCsvRow(record, timestampFormatter, row, sizeof(row));
+    if (length > 0) {
+        if (index && written % indexInterval == 0) {
+            index->add(record.timestampNs, offset);
+        }
+        file.write(row, static_cast<std::streamsize>(length));
+        offset += length;
+        written++;
+    }
+}
+
+void CsvLogSink::flush() {
+    file.flush();
+    if (index) {
+        index->flush();
+    }
+}
+
+LogWriterStats CsvLogSink::stats() const {
+    LogWriterStats result;
+    result.queued = written;
+    result.written = written;
+    return result;
+}
+
+AsyncLogWriter::AsyncLogWriter(std::unique_ptr<LogSink> target, const AsyncLogOptions& options)
+    : target(std::move(target))
+    , options(options)
+    , queue(options.queueCapacity)
+{
+    if (this->target && this->target->isOpen()) {
+        worker = std::thread(&AsyncLogWriter::run, this);
+    }
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    stopping.store(true, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool AsyncLogWriter::isOpen() const {
+    return worker.joinable();
+}
+
+/**
+ * @brief Queues a record for the logger thread
+ *
+ * Hot path: one copy into the ring plus a relaxed counter update. When the
+ * ring is full the OverflowPolicy decides between dropping and waiting.
+ */
+void AsyncLogWriter::write(const LogRecord& record) {
+    if (queue.tryPush(record)) {
+        queued.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (options.overflow == OverflowPolicy::BLOCK && worker.joinable()) {
+        while (!queue.tryPush(record)) {
+            std::this_thread::yield();
+        }
+        queued.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncLogWriter::flush() {
+    flushRequested.store(true, std::memory_order_release);
+}
+
+void AsyncLogWriter::sync() {
+    // Records are written in queue order, so flushedThrough reaching the
+    // queued count means all of them are in the target. A flush can cover
+    // only part of the queue (FlushPolicy::everyRecords): ask again.
+    const std::uint64_t target = queued.load(std::memory_order_relaxed);
+    while (worker.joinable() && flushedThrough.load(std::memory_order_acquire) < target) {
+        flushRequested.store(true, std::memory_order_release);
+        std::this_thread::sleep_for(options.idleWait);
+    }
+}
+
+LogWriterStats AsyncLogWriter::stats() const {
+    LogWriterStats result;
+    result.queued = queued.load(std::memory_order_relaxed);
+    result.written = written.load(std::memory_order_relaxed);
+    result.dropped = dropped.load(std::memory_order_relaxed);
+    return result;
+}
+
+/**
+ * @brief Logger thread main loop
+ *
+ * Drains the ring into the target sink and applies the FlushPolicy. On
+ * shutdown the remaining records are drained before the final flush.
+ */
+void AsyncLogWriter::run() {
+    using Clock = std::chrono::steady_clock;
+    const FlushPolicy& policy = options.flush;
+
+    std::size_t unflushed = 0;
+    bool haveState = false;
+    MachineState lastState = MachineState::IDLE;
+    Clock::time_point lastFlush = Clock::now();
+    LogRecord record;
+    pthread_setname_np(pthread_self(), "labelm-logger");
+
+    for (;;) {
+        // Read the stop flag before draining so nothing queued before the
+        // destructor ran can be left behind.
+        const bool stopRequested = stopping.load(std::memory_order_acquire);
+
+        bool stateChanged = false;
+        while (queue.tryPop(record)) {
+            target->write(record);
+            written.fetch_add(1, std::memory_order_relaxed);
+            unflushed++;
+            if (haveState && record.state != lastState) {
+                stateChanged = true;
+            }
+            lastState = record.state;
+            haveState = true;
+            if (policy.everyRecords > 0 && unflushed >= policy.everyRecords) {
+                break;
+            }
+        }
+
+        const Clock::time_point now = Clock::now();
+        const bool countDue = policy.everyRecords > 0 && unflushed >= policy.everyRecords;
+        const bool timeDue = policy.interval.count() > 0 && unflushed > 0
+                             && now - lastFlush >= policy.interval;
+        const bool stateDue = policy.onStateChange && stateChanged;
+        if (countDue || timeDue || stateDue
+            || flushRequested.exchange(false, std::memory_order_acq_rel)) {
+            TraceSpan span(options.trace, "log flush", "log");
+            target->flush();
+            flushedThrough.store(written.load(std::memory_order_relaxed), std::memory_order_release);
+            unflushed = 0;
+            lastFlush = now;
+        }
+
+        if (stopRequested && queue.size() == 0) {
+            break;
+        }
+        if (queue.size() == 0) {
+            std::this_thread::sleep_for(options.idleWait);
+        }
+    }
+    target->flush();
+    flushedThrough.store(written.load(std::memory_order_relaxed), std::memory_order_release);
+}
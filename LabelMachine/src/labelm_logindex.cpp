@@ -0,0 +1,133 @@
+#include "labelm_logindex.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::string logIndexPath(const std::string& logPath) {
+    return logPath + ".idx";
+}
+
+LogIndexWriter::LogIndexWriter(const std::string& path, std::uint32_t interval, bool append)
+    : file(path, std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc))
+{
+    if (file && file.tellp() == std::streampos(0)) {
+        LogIndexHeader header = {};
+        std::memcpy(header.magic, LOG_INDEX_MAGIC, sizeof(header.magic));
+        header.version = LOG_INDEX_VERSION;
+        header.entrySize = sizeof(LogIndexEntry);
+        header.interval = interval;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+}
+
+void LogIndexWriter::add(std::int64_t timestampNs, std::uint64_t offset) {
+    const LogIndexEntry entry = {timestampNs, offset};
+    file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+}
+
+bool readLogIndex(const std::string& path, std::vector<LogIndexEntry>& entries, std::string& error) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    LogIndexHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, LOG_INDEX_MAGIC, sizeof(header.magic)) != 0
+        || header.version != LOG_INDEX_VERSION || header.entrySize != sizeof(LogIndexEntry)) {
+        error = path + " is not a production log index";
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    const std::streamoff bytes = in.tellg() - static_cast<std::streamoff>(sizeof(header));
+    in.seekg(sizeof(header));
+    // A partially written last entry (crash) is ignored
+    entries.resize(static_cast<std::size_t>(bytes) / sizeof(LogIndexEntry));
+    in.read(reinterpret_cast<char*>(entries.data()),
+            static_cast<std::streamsize>(entries.size() * sizeof(LogIndexEntry)));
+    return static_cast<bool>(in) || entries.empty();
+}
+
+std::uint64_t findLogOffset(const std::vector<LogIndexEntry>& entries, std::int64_t timestampNs) {
+    // First entry not before timestampNs; the rows wanted may start just
+    // before it, so the scan begins at the entry before that
+    auto it = std::lower_bound(entries.begin(), entries.end(), timestampNs,
+                               [](const LogIndexEntry& entry, std::int64_t ts) { return entry.timestampNs < ts; });
+    return it == entries.begin() ? 0 : std::prev(it)->offset;
+}
+
+bool queryCsvLog(const std::string& logPath, std::int64_t fromNs, std::int64_t toNs,
+                 const std::function<void(const CsvLogRow&, const char*, std::size_t)>& callback,
+                 std::string& error, LogQueryStats* stats) {
+    LogQueryStats result;
+    std::vector<LogIndexEntry> entries;
+    std::string indexError;
+    if (readLogIndex(logIndexPath(logPath), entries, indexError)) {
+        result.usedIndex = true;
+        result.startOffset = findLogOffset(entries, fromNs);
+    }
+
+    int fd = ::open(logPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + logPath;
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        error = "cannot stat " + logPath;
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    if (result.startOffset >= size) {
+        // Index ahead of the log (log lost its unflushed tail): scan everything
+        result.startOffset = 0;
+    }
+    if (size == 0) {
+        ::close(fd);
+        if (stats != nullptr) {
+            *stats = result;
+        }
+        return true;
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + logPath;
+        return false;
+    }
+
+    const char* data = static_cast<const char*>(mapping);
+    const char* const fileEnd = data + size;
+    const char* line = data + result.startOffset;
+    TimestampParser parser;
+    CsvLogRow row;
+    while (line < fileEnd) {
+        const char* newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(fileEnd - line)));
+        if (newline == nullptr) {
+            break;      // Partial last row
+        }
+        if (parseCsvLogRow(line, newline, parser, row)) {
+            if (row.timestampNs > toNs) {
+                line = newline + 1;
+                break;
+            }
+            if (row.timestampNs >= fromNs) {
+                result.rowsMatched++;
+                callback(row, line, static_cast<std::size_t>(newline - line));
+            }
+        }
+        line = newline + 1;
+    }
+    result.bytesScanned = static_cast<std::uint64_t>(std::min(line, fileEnd) - (data + result.startOffset));
+    ::munmap(mapping, size);
+    if (stats != nullptr) {
+        *stats = result;
+    }
+    return true;
+}
@@ -0,0 +1,278 @@
+#include "labelm_metrics.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "labelm_statemachine.h"
+
+namespace {
+
+/// Longest request head accepted before the connection is dropped
+constexpr std::size_t MAX_REQUEST_BYTES = 8192;
+
+/// epoll_wait timeout; bounds the shutdown latency and the timeout check
+constexpr int IDLE_WAIT_MS = 100;
+
+/// A connection must send its request and take the response within this time
+constexpr std::chrono::seconds CONNECTION_TIMEOUT(5);
+
+/// Open client connections; further clients are closed right after accept
+constexpr std::size_t MAX_CONNECTIONS = 64;
+
+/// Histogram bucket bounds exposed to Prometheus (ns)
+constexpr std::int64_t PROMETHEUS_BOUNDS_NS[] = {
+    250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000};
+
+void appendFormat(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+void appendFormat(std::string& out, const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    const int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length > 0) {
+        out.append(buffer, std::min(static_cast<std::size_t>(length), sizeof(buffer) - 1));
+    }
+}
+
+void appendHeader(std::string& out, bool withHelp, const char* name, const char* type, const char* help) {
+    if (withHelp) {
+        appendFormat(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    }
+}
+
+/// One client connection of the metrics server
+struct Connection {
+    std::chrono::steady_clock::time_point acceptedAt;
+    std::string request;
+    std::string response;
+    std::size_t sent = 0;
+};
+
+} // namespace
+
+void appendMetricsText(std::string& out, const std::string& machineId, const MachineMetrics& metrics,
+                       const LatencyRecorder* latency, bool withHelp) {
+    const char* id = machineId.c_str();
+    appendHeader(out, withHelp, "labelm_products_labeled_total", "counter", "Products labeled in the current session");
+    appendFormat(out, "labelm_products_labeled_total{machine=\"%s\"} %lld\n", id,
+                 static_cast<long long>(metrics.productsLabeled.load(std::memory_order_relaxed)));
+    appendHeader(out, withHelp, "labelm_errors_total", "counter", "Labeling errors in the current session");
+    appendFormat(out, "labelm_errors_total{machine=\"%s\"} %lld\n", id,
+                 static_cast<long long>(metrics.errorCount.load(std::memory_order_relaxed)));
+    appendHeader(out, withHelp, "labelm_label_roll_remaining", "gauge", "Labels left on the roll");
+    appendFormat(out, "labelm_label_roll_remaining{machine=\"%s\"} %d\n", id,
+                 metrics.labelRollRemaining.load(std::memory_order_relaxed));
+    appendHeader(out, withHelp, "labelm_temperature_celsius", "gauge", "System temperature");
+    appendFormat(out, "labelm_temperature_celsius{machine=\"%s\"} %.2f\n", id,
+                 metrics.temperature.load(std::memory_order_relaxed));
+    appendHeader(out, withHelp, "labelm_conveyor_speed_mm_per_second", "gauge", "Conveyor speed");
+    appendFormat(out, "labelm_conveyor_speed_mm_per_second{machine=\"%s\"} %d\n", id,
+                 metrics.conveyorSpeed.load(std::memory_order_relaxed));
+
+    appendHeader(out, withHelp, "labelm_state", "gauge", "1 for the machine's current state");
+    const std::uint8_t state = metrics.state.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < MACHINE_STATE_COUNT; i++) {
+        appendFormat(out, "labelm_state{machine=\"%s\",state=\"%s\"} %d\n", id,
+                     machineStateName(static_cast<MachineState>(i)), state == i ? 1 : 0);
+    }
+
+    if (latency == nullptr) {
+        return;
+    }
+    appendHeader(out, withHelp, "labelm_operation_duration_seconds", "histogram", "Duration of machine operations");
+    for (std::size_t op = 0; op < METRIC_OPERATION_COUNT; op++) {
+        const LatencySummary summary = latency->summary(static_cast<MetricOperation>(op));
+        const char* name = metricOperationName(static_cast<MetricOperation>(op));
+        std::uint64_t cumulative = 0;
+        std::size_t bucket = 0;
+        for (std::int64_t boundNs : PROMETHEUS_BOUNDS_NS) {
+            while (bucket < LATENCY_BUCKETS && latencyBucketUpperNs(bucket) <= static_cast<std::uint64_t>(boundNs)) {
+                cumulative += summary.buckets[bucket++];
+            }
+            appendFormat(out, "labelm_operation_duration_seconds_bucket{machine=\"%s\",operation=\"%s\",le=\"%g\"} %llu\n",
+                         id, name, boundNs / 1e9, static_cast<unsigned long long>(cumulative));
+        }
+        appendFormat(out, "labelm_operation_duration_seconds_bucket{machine=\"%s\",operation=\"%s\",le=\"+Inf\"} %llu\n",
+                     id, name, static_cast<unsigned long long>(summary.count));
+        appendFormat(out, "labelm_operation_duration_seconds_sum{machine=\"%s\",operation=\"%s\"} %.9f\n",
+                     id, name, summary.sumNs / 1e9);
+        appendFormat(out, "labelm_operation_duration_seconds_count{machine=\"%s\",operation=\"%s\"} %llu\n",
+                     id, name, static_cast<unsigned long long>(summary.count));
+    }
+}
+
+MetricsServer::MetricsServer(std::uint16_t port, std::function<void(std::string&)> render)
+    : render(std::move(render))
+{
+    listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        return;
+    }
+    const int reuse = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(listenFd, 16) != 0
+        || ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        return;
+    }
+    boundPort = ntohs(address.sin_port);
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    if (epollFd < 0 || ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) != 0) {
+        if (epollFd >= 0) {
+            ::close(epollFd);
+            epollFd = -1;
+        }
+        ::close(listenFd);
+        listenFd = -1;
+        return;
+    }
+    worker = std::thread(&MetricsServer::run, this);
+}
+
+MetricsServer::~MetricsServer() {
+    stopping.store(true, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (epollFd >= 0) {
+        ::close(epollFd);
+    }
+    if (listenFd >= 0) {
+        ::close(listenFd);
+    }
+}
+
+void MetricsServer::run() {
+    std::unordered_map<int, Connection> connections;
+    epoll_event ready[16];
+    char buffer[4096];
+
+    auto closeConnection = [&](int fd) {
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        connections.erase(fd);
+    };
+
+    while (!stopping.load(std::memory_order_acquire)) {
+        const int count = ::epoll_wait(epollFd, ready, 16, IDLE_WAIT_MS);
+        for (int i = 0; i < count; i++) {
+            const int fd = ready[i].data.fd;
+            if (fd == listenFd) {
+                int client;
+                while ((client = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                    epoll_event event = {};
+                    event.events = EPOLLIN;
+                    event.data.fd = client;
+                    if (connections.size() >= MAX_CONNECTIONS
+                        || ::epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &event) != 0) {
+                        ::close(client);
+                        continue;
+                    }
+                    connections[client].acceptedAt = std::chrono::steady_clock::now();
+                }
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            Connection& connection = it->second;
+            if (ready[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(fd);
+                continue;
+            }
+
+            if (connection.response.empty()) {
+                ssize_t length;
+                while ((length = ::read(fd, buffer, sizeof(buffer))) > 0) {
+                    connection.request.append(buffer, static_cast<std::size_t>(length));
+                }
+                if (length == 0 || (length < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+                    || connection.request.size() > MAX_REQUEST_BYTES) {
+                    closeConnection(fd);
+                    continue;
+                }
+                if (connection.request.find("\r\n\r\n") == std::string::npos) {
+                    continue;   // Request head not complete yet
+                }
+
+                // Scrape: format everything now, on this thread
+                std::string body;
+                const char* status = "404 Not Found";
+                // Scrapers may add a query string (GET /metrics?name[]=...)
+                if (connection.request.compare(0, 12, "GET /metrics") == 0
+                    && (connection.request[12] == ' ' || connection.request[12] == '?')) {
+                    status = "200 OK";
+                    render(body);
+                } else {
+                    body = "Not found; metrics are served at /metrics\n";
+                }
+                char head[192];
+                std::snprintf(head, sizeof(head),
+                              "HTTP/1.1 %s\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                              "Content-Length: %zu\r\nConnection: close\r\n\r\n", status, body.size());
+                connection.response = head;
+                connection.response += body;
+                epoll_event event = {};
+                event.events = EPOLLOUT;
+                event.data.fd = fd;
+                ::epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+            }
+
+            bool failed = false;
+            while (connection.sent < connection.response.size()) {
+                const ssize_t length = ::send(fd, connection.response.data() + connection.sent,
+                                              connection.response.size() - connection.sent, MSG_NOSIGNAL);
+                if (length < 0) {
+                    failed = errno != EAGAIN && errno != EWOULDBLOCK;
+                    break;  // Socket buffer full: continue on EPOLLOUT
+                }
+                connection.sent += static_cast<std::size_t>(length);
+            }
+            if (failed || connection.sent == connection.response.size()) {
+                closeConnection(fd);
+            }
+        }
+
+        // Idle and stalled clients must not hold connections forever
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() - CONNECTION_TIMEOUT;
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (it->second.acceptedAt < deadline) {
+                ::epoll_ctl(epollFd, EPOLL_CTL_DEL, it->first, nullptr);
+                ::close(it->first);
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (auto& entry : connections) {
+        ::close(entry.first);
+    }
+}
@@ -0,0 +1,175 @@
+#include "labelm_oee.h"
+
+#include <algorithm>
+
+namespace {
+
+bool isRunState(MachineState state) {
+    return state == MachineState::RUNNING || state == MachineState::LOW_LABEL;
+}
+
+bool isDownState(MachineState state) {
+    return state == MachineState::PAUSED || state == MachineState::ERROR;
+}
+
+/// Floor division so pre-epoch times map to the right bucket
+std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+    std::int64_t quotient = value / divisor;
+    if (value % divisor != 0 && value < 0) {
+        quotient--;
+    }
+    return quotient;
+}
+
+double ratio(double part, double whole) {
+    return whole > 0.0 ? part / whole : 0.0;
+}
+
+} // namespace
+
+OeeWindow::OeeWindow(std::chrono::nanoseconds length, std::size_t bucketCount)
+    : bucketNs(std::max<std::int64_t>(1, length.count() / static_cast<std::int64_t>(std::max<std::size_t>(1, bucketCount))))
+    , buckets(std::max<std::size_t>(1, bucketCount))
+{
+}
+
+void OeeWindow::clear() {
+    std::fill(buckets.begin(), buckets.end(), Bucket());
+}
+
+OeeWindow::Bucket& OeeWindow::bucketFor(std::int64_t epoch) {
+    const std::size_t count = buckets.size();
+    Bucket& bucket = buckets[static_cast<std::size_t>(((epoch % static_cast<std::int64_t>(count)) + count) % count)];
+    if (bucket.epoch != epoch) {
+        bucket = Bucket();
+        bucket.epoch = epoch;
+    }
+    return bucket;
+}
+
+std::int64_t OeeWindow::windowStart(std::int64_t nowNs) const {
+    return (floorDiv(nowNs, bucketNs) - static_cast<std::int64_t>(buckets.size()) + 1) * bucketNs;
+}
+
+/**
+ * @brief Splits the interval at bucket boundaries
+ *
+ * Only the part inside the window ending at toNs is kept; anything older
+ * would be overwritten anyway.
+ */
+void OeeWindow::addTime(std::int64_t fromNs, std::int64_t toNs, bool running, double idealPerNs) {
+    fromNs = std::max(fromNs, windowStart(toNs));
+    while (fromNs < toNs) {
+        const std::int64_t epoch = floorDiv(fromNs, bucketNs);
+        const std::int64_t end = std::min(toNs, (epoch + 1) * bucketNs);
+        Bucket& bucket = bucketFor(epoch);
+        if (running) {
+            bucket.runNs += end - fromNs;
+            bucket.idealCount += (end - fromNs) * idealPerNs;
+        } else {
+            bucket.downNs += end - fromNs;
+        }
+        fromNs = end;
+    }
+}
+
+void OeeWindow::addLabel(std::int64_t timeNs, bool success) {
+    Bucket& bucket = bucketFor(floorDiv(timeNs, bucketNs));
+    if (success) {
+        bucket.good++;
+    } else {
+        bucket.rejected++;
+    }
+}
+
+OeeFigures OeeWindow::figures(std::int64_t nowNs, std::int64_t openSinceNs, bool openRunning,
+                              bool openDown, double idealPerNs) const {
+    OeeFigures result;
+    const std::int64_t nowEpoch = floorDiv(nowNs, bucketNs);
+    const std::int64_t oldest = nowEpoch - static_cast<std::int64_t>(buckets.size()) + 1;
+    result.windowNs = static_cast<std::int64_t>(buckets.size()) * bucketNs;
+    for (const Bucket& bucket : buckets) {
+        if (bucket.epoch < oldest || bucket.epoch > nowEpoch) {
+            continue;
+        }
+        result.runNs += bucket.runNs;
+        result.downNs += bucket.downNs;
+        result.good += bucket.good;
+        result.rejected += bucket.rejected;
+        result.idealCount += bucket.idealCount;
+    }
+
+    const std::int64_t openNs = nowNs - std::max(openSinceNs, oldest * bucketNs);
+    if (openNs > 0) {
+        if (openRunning) {
+            result.runNs += openNs;
+            result.idealCount += openNs * idealPerNs;
+        } else if (openDown) {
+            result.downNs += openNs;
+        }
+    }
+
+    const std::uint64_t attempts = result.good + result.rejected;
+    result.availability = ratio(static_cast<double>(result.runNs), static_cast<double>(result.runNs + result.downNs));
+    result.performance = ratio(static_cast<double>(result.good + result.rejected), result.idealCount);
+    result.quality = ratio(static_cast<double>(result.good), static_cast<double>(attempts));
+    result.oee = result.availability * result.performance * result.quality;
+    return result;
+}
+
+OeeCalculator::OeeCalculator(std::chrono::nanoseconds shiftLength)
+    : minute(std::chrono::minutes(1), BUCKETS_PER_WINDOW)
+    , quarterHour(std::chrono::minutes(15), BUCKETS_PER_WINDOW)
+    , shift(shiftLength, BUCKETS_PER_WINDOW)
+{
+}
+
+void OeeCalculator::reset(std::int64_t nowNs, MachineState newState) {
+    minute.clear();
+    quarterHour.clear();
+    shift.clear();
+    sinceNs = nowNs;
+    state = newState;
+}
+
+/**
+ * @brief Adds the time since the last update to the windows
+ */
+void OeeCalculator::accrue(std::int64_t nowNs) {
+    if (nowNs <= sinceNs) {
+        return;
+    }
+    if (isRunState(state) || isDownState(state)) {
+        const bool running = isRunState(state);
+        minute.addTime(sinceNs, nowNs, running, idealPerNs);
+        quarterHour.addTime(sinceNs, nowNs, running, idealPerNs);
+        shift.addTime(sinceNs, nowNs, running, idealPerNs);
+    }
+    sinceNs = nowNs;
+}
+
+void OeeCalculator::setIdealRate(double labelsPerSecond, std::int64_t nowNs) {
+    accrue(nowNs);
+    idealPerNs = labelsPerSecond > 0.0 ? labelsPerSecond / 1e9 : 0.0;
+}
+
+void OeeCalculator::onTransition(MachineState to, std::int64_t nowNs) {
+    accrue(nowNs);
+    state = to;
+}
+
+void OeeCalculator::onLabel(bool success, std::int64_t nowNs) {
+    minute.addLabel(nowNs, success);
+    quarterHour.addLabel(nowNs, success);
+    shift.addLabel(nowNs, success);
+}
+
+OeeReport OeeCalculator::report(std::int64_t nowNs) const {
+    const bool running = isRunState(state);
+    const bool down = isDownState(state);
+    OeeReport result;
+    result.lastMinute = minute.figures(nowNs, sinceNs, running, down, idealPerNs);
+    result.last15Minutes = quarterHour.figures(nowNs, sinceNs, running, down, idealPerNs);
+    result.shift = shift.figures(nowNs, sinceNs, running, down, idealPerNs);
+    return result;
+}
@@ -0,0 +1,184 @@
+#include "labelm_ramp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Phase lengths of a jerk-limited ramp over a speed change
+ *
+ * The acceleration rises for jerkTime, holds its peak for holdTime and
+ * falls for jerkTime. Short changes never reach the acceleration limit.
+ */
+struct SCurvePhases {
+    double jerkTime;        ///< s, rise (and fall) of the acceleration
+    double holdTime;        ///< s, at peak acceleration
+    double peak;            ///< mm/s^2, peak acceleration
+};
+
+SCurvePhases sCurvePhases(double change, double acceleration, double jerk) {
+    SCurvePhases phases;
+    if (change >= acceleration * acceleration / jerk) {
+        phases.peak = acceleration;
+        phases.jerkTime = acceleration / jerk;
+        phases.holdTime = change / acceleration - phases.jerkTime;
+    } else {
+        phases.peak = std::sqrt(change * jerk);
+        phases.jerkTime = phases.peak / jerk;
+        phases.holdTime = 0.0;
+    }
+    return phases;
+}
+
+} // namespace
+
+double RampPlan::duration() const {
+    const double change = std::abs(toSpeed - fromSpeed);
+    if (change == 0.0) {
+        return 0.0;
+    }
+    if (profile == RampProfile::TRAPEZOIDAL) {
+        return change / acceleration;
+    }
+    const SCurvePhases phases = sCurvePhases(change, acceleration, jerk);
+    return 2.0 * phases.jerkTime + phases.holdTime;
+}
+
+int RampPlan::speedAt(double seconds) const {
+    const double total = duration();
+    if (seconds >= total) {
+        return toSpeed;
+    }
+    if (seconds <= 0.0) {
+        return fromSpeed;
+    }
+    const double direction = toSpeed > fromSpeed ? 1.0 : -1.0;
+    double gained;
+    if (profile == RampProfile::TRAPEZOIDAL) {
+        gained = acceleration * seconds;
+    } else {
+        const SCurvePhases phases = sCurvePhases(std::abs(toSpeed - fromSpeed), acceleration, jerk);
+        if (seconds < phases.jerkTime) {
+            gained = jerk * seconds * seconds / 2.0;
+        } else if (seconds < phases.jerkTime + phases.holdTime) {
+            gained = jerk * phases.jerkTime * phases.jerkTime / 2.0 + phases.peak * (seconds - phases.jerkTime);
+        } else {
+            // Mirror image of the rise: measure back from the end
+            const double left = total - seconds;
+            gained = std::abs(toSpeed - fromSpeed) - jerk * left * left / 2.0;
+        }
+    }
+    return fromSpeed + static_cast<int>(std::lround(direction * gained));
+}
+
+SpeedRamp::SpeedRamp(const RampPlan& plan, std::function<void(int)> onTick, const MachineClock* clock)
+    : rampPlan(plan)
+    , durationSeconds(plan.duration())
+    , onTick(std::move(onTick))
+    , clock(clock)
+    , startedNs(nowNs())
+    , setpoint(plan.fromSpeed)
+{}
+
+std::int64_t SpeedRamp::nowNs() const {
+    return clock != nullptr ? clock->nowNs() : monotonicTimeNs();
+}
+
+double SpeedRamp::elapsedSeconds() const {
+    return (nowNs() - startedNs) / 1e9;
+}
+
+bool SpeedRamp::advance() {
+    if (cancelled.load(std::memory_order_acquire)) {
+        return false;
+    }
+    const double seconds = elapsedSeconds();
+    const int speed = rampPlan.speedAt(seconds);
+    setpoint.store(speed, std::memory_order_release);
+    if (onTick) {
+        onTick(speed);
+    }
+    if (seconds >= durationSeconds) {
+        done.store(true, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+RampEngine::RampEngine(std::chrono::milliseconds tick)
+    : tick(tick.count() > 0 ? tick : std::chrono::milliseconds(1))
+    , worker(&RampEngine::run, this)
+{}
+
+RampEngine::~RampEngine() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    worker.join();
+}
+
+std::shared_ptr<SpeedRamp> RampEngine::start(const RampPlan& plan, std::function<void(int)> onTick,
+                                             const MachineClock* clock) {
+    std::shared_ptr<SpeedRamp> ramp = std::make_shared<SpeedRamp>(plan, std::move(onTick), clock);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ramps.push_back(ramp);
+    }
+    wakeup.notify_all();
+    return ramp;
+}
+
+std::size_t RampEngine::active() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ramps.size();
+}
+
+RampEngine& RampEngine::shared() {
+    static RampEngine engine;
+    return engine;
+}
+
+/**
+ * @brief Engine thread: one pass over all ramps per tick, asleep while idle
+ *
+ * Ramps are advanced outside the lock, so onTick callbacks and start()
+ * calls from other threads never wait on each other.
+ */
+void RampEngine::run() {
+    std::vector<std::shared_ptr<SpeedRamp>> current;
+    std::unique_lock<std::mutex> lock(mutex);
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now();
+    while (!stopping) {
+        if (ramps.empty()) {
+            wakeup.wait(lock, [this] { return stopping || !ramps.empty(); });
+            deadline = std::chrono::steady_clock::now();
+            continue;
+        }
+        current = ramps;
+        lock.unlock();
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        bool finished = false;
+        for (const std::shared_ptr<SpeedRamp>& ramp : current) {
+            finished |= !ramp->advance();
+        }
+        current.clear();
+
+        lock.lock();
+        if (finished) {
+            ramps.erase(std::remove_if(ramps.begin(), ramps.end(), [](const std::shared_ptr<SpeedRamp>& ramp) {
+                return ramp->isDone() || ramp->cancelled.load(std::memory_order_acquire);
+            }), ramps.end());
+        }
+        // Fixed-rate ticks; skip ticks that were missed rather than bunch them up
+        deadline += tick;
+        if (deadline < now) {
+            deadline = now + tick;
+        }
+        wakeup.wait_until(lock, deadline, [this] { return stopping; });
+    }
+}
@@ -0,0 +1,269 @@
+#include "labelm_replay.h"
+
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef LABELM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+/// Parses an optionally negative decimal integer ending at `stop`
+bool parseInt(const char*& cursor, const char* end, char stop, std::int32_t& value) {
+    const char* p = cursor;
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    const char* digits = p;
+    std::int64_t result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p - '0');
+        if (result > INT32_MAX) {
+            return false;
+        }
+        p++;
+    }
+    if (p == digits || p >= end || *p != stop) {
+        return false;
+    }
+    value = static_cast<std::int32_t>(negative ? -result : result);
+    cursor = p + 1;
+    return true;
+}
+
+/// Parses a fixed-point decimal (as written with %.1f) ending at `stop`
+bool parseDecimal(const char*& cursor, const char* end, char stop, double& value) {
+    static const double SCALE[] = {1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0};
+    const char* p = cursor;
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    const char* digits = p;
+    std::int64_t whole = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        whole = whole * 10 + (*p - '0');
+        p++;
+    }
+    if (p == digits) {
+        return false;
+    }
+    std::int64_t fraction = 0;
+    int fractionDigits = 0;
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9' && fractionDigits < 6) {
+            fraction = fraction * 10 + (*p - '0');
+            fractionDigits++;
+            p++;
+        }
+    }
+    if (p >= end || *p != stop) {
+        return false;
+    }
+    const double result = whole + fraction / SCALE[fractionDigits];
+    value = negative ? -result : result;
+    cursor = p + 1;
+    return true;
+}
+
+bool matches(const char* begin, const char* end, const char* word) {
+    const std::size_t length = std::strlen(word);
+    return static_cast<std::size_t>(end - begin) == length && std::memcmp(begin, word, length) == 0;
+}
+
+/**
+ * @brief Folds the lines of a log, in file order, into a ReplaySummary
+ */
+class ReplayTally {
+public:
+    ReplayTally(ReplaySummary& summary, const std::function<void(const CsvLogRow&)>& callback)
+        : summary(summary)
+        , callback(callback)
+        , headerLength(std::strlen(CSV_LOG_HEADER))
+    {}
+
+    /**
+     * @param complete false for a last line without newline (counted as malformed)
+     */
+    void addLine(const char* line, const char* lineEnd, bool complete) {
+        const bool header = static_cast<std::size_t>(lineEnd - line + 1) == headerLength
+                            && std::memcmp(line, CSV_LOG_HEADER, headerLength - 1) == 0;
+        if (header || lineEnd == line) {
+            // Header row and blank lines
+        } else if (complete && parseCsvLogRow(line, lineEnd, parser, row)) {
+            if (!haveRow) {
+                summary.firstTimestampNs = row.timestampNs;
+                haveRow = true;
+            }
+            last = row;
+            summary.rows++;
+            if (row.status == LogStatus::SUCCESS) {
+                summary.successRows++;
+            } else {
+                summary.failureRows++;
+            }
+            if (callback) {
+                callback(row);
+            }
+        } else {
+            summary.malformedRows++;
+        }
+    }
+
+    /**
+     * @brief Derives the counters from the last row
+     */
+    void finish() {
+        if (haveRow) {
+            // FAILURE rows carry the id of the product that was not labeled
+            summary.productsLabeled = last.status == LogStatus::SUCCESS ? last.productId : last.productId - 1;
+            summary.errorCount = static_cast<int>(summary.failureRows);
+            summary.lastTemperature = last.temperature;
+            summary.lastSpeed = last.conveyorSpeed;
+            summary.lastTimestampNs = last.timestampNs;
+        }
+    }
+
+private:
+    ReplaySummary& summary;
+    const std::function<void(const CsvLogRow&)>& callback;
+    const std::size_t headerLength;
+    TimestampParser parser;
+    CsvLogRow row;
+    CsvLogRow last;                 // row may hold a failed parse
+    bool haveRow = false;
+};
+
+} // namespace
+
+bool parseCsvLogRow(const char* begin, const char* end, TimestampParser& parser, CsvLogRow& row) {
+    if (end > begin && end[-1] == '\r') {
+        end--;
+    }
+    const char* comma = static_cast<const char*>(std::memchr(begin, ',', static_cast<std::size_t>(end - begin)));
+    if (comma == nullptr || !parser.parse(begin, static_cast<std::size_t>(comma - begin), row.timestampNs)) {
+        return false;
+    }
+    const char* cursor = comma + 1;
+    if (!parseInt(cursor, end, ',', row.productId)
+        || !parseDecimal(cursor, end, ',', row.temperature)
+        || !parseInt(cursor, end, ',', row.conveyorSpeed)) {
+        return false;
+    }
+    if (matches(cursor, end, "SUCCESS")) {
+        row.status = LogStatus::SUCCESS;
+    } else if (matches(cursor, end, "FAILURE")) {
+        row.status = LogStatus::FAILURE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool replayCsvLog(const std::string& path, ReplaySummary& summary, std::string& error,
+                  const std::function<void(const CsvLogRow&)>& callback) {
+    summary = ReplaySummary();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        error = "cannot stat " + path;
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    summary.bytes = size;
+    if (size == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    // One front-to-back pass: let the kernel read ahead aggressively
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+
+    const char* data = static_cast<const char*>(mapping);
+    const char* const fileEnd = data + size;
+    ReplayTally tally(summary, callback);
+    const char* line = data;
+    while (line < fileEnd) {
+        const char* newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(fileEnd - line)));
+        const char* lineEnd = newline != nullptr ? newline : fileEnd;
+        tally.addLine(line, lineEnd, newline != nullptr);
+        line = lineEnd + 1;
+    }
+    tally.finish();
+    ::munmap(mapping, size);
+    return true;
+}
+
+bool replayCompressedCsvLog(const std::string& path, ReplaySummary& summary, std::string& error,
+                            const std::function<void(const CsvLogRow&)>& callback) {
+    summary = ReplaySummary();
+#ifdef LABELM_HAVE_ZLIB
+    gzFile in = gzopen(path.c_str(), "rb");
+    if (in == nullptr) {
+        error = "cannot open " + path;
+        return false;
+    }
+    ReplayTally tally(summary, callback);
+    std::vector<char> chunk(64 * 1024);
+    std::string carry;              // Line split across chunks
+    for (;;) {
+        const int length = gzread(in, chunk.data(), static_cast<unsigned>(chunk.size()));
+        if (length < 0) {
+            gzclose(in);
+            error = "cannot decompress " + path;
+            return false;
+        }
+        if (length == 0) {
+            break;
+        }
+        summary.bytes += static_cast<std::uint64_t>(length);
+        const char* line = chunk.data();
+        const char* const chunkEnd = line + length;
+        while (line < chunkEnd) {
+            const char* newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(chunkEnd - line)));
+            if (newline == nullptr) {
+                carry.append(line, chunkEnd);
+                break;
+            }
+            if (carry.empty()) {
+                tally.addLine(line, newline, true);
+            } else {
+                carry.append(line, newline);
+                tally.addLine(carry.data(), carry.data() + carry.size(), true);
+                carry.clear();
+            }
+            line = newline + 1;
+        }
+    }
+    gzclose(in);
+    if (!carry.empty()) {
+        tally.addLine(carry.data(), carry.data() + carry.size(), false);
+    }
+    tally.finish();
+    return true;
+#else
+    (void)callback;
+    error = "cannot read " + path + ": built without zlib";
+    return false;
+#endif
+}
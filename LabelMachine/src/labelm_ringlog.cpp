@@ -0,0 +1,160 @@
+#include "labelm_ringlog.h"
+
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::size_t ringFileSize(std::uint64_t capacity) {
+    return sizeof(RingLogHeader) + static_cast<std::size_t>(capacity) * sizeof(JournalRecord);
+}
+
+bool headerMatches(const RingLogHeader* header, std::uint64_t capacity) {
+    return std::memcmp(header->magic, RING_LOG_MAGIC, sizeof(header->magic)) == 0
+        && header->version == RING_LOG_VERSION
+        && header->recordSize == sizeof(JournalRecord)
+        && (capacity == 0 || header->capacity == capacity);
+}
+
+} // namespace
+
+MappedRingLogSink::MappedRingLogSink(const std::string& path, std::size_t capacity) {
+    if (capacity == 0) {
+        return;
+    }
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return;
+    }
+
+    const std::size_t size = ringFileSize(capacity);
+    struct stat info;
+    bool reuse = ::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) == size;
+    if (!reuse && (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+        ::close(fd);
+        return;
+    }
+
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return;
+    }
+    mappedBytes = size;
+    header = static_cast<RingLogHeader*>(mapping);
+    slots = reinterpret_cast<JournalRecord*>(static_cast<char*>(mapping) + sizeof(RingLogHeader));
+
+    if (!reuse || !headerMatches(header, capacity)) {
+        // Fresh (zero-filled) file: the magic goes in last so a crash
+        // during initialisation never leaves a valid-looking header.
+        header->version = RING_LOG_VERSION;
+        header->recordSize = sizeof(JournalRecord);
+        header->capacity = capacity;
+        header->head.store(0, std::memory_order_relaxed);
+        header->tail.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, RING_LOG_MAGIC, sizeof(header->magic));
+    }
+}
+
+MappedRingLogSink::~MappedRingLogSink() {
+    if (header != nullptr) {
+        ::msync(header, mappedBytes, MS_ASYNC);
+        ::munmap(header, mappedBytes);
+    }
+}
+
+bool MappedRingLogSink::isOpen() const {
+    return header != nullptr;
+}
+
+/**
+ * @brief Stores one record in the ring
+ *
+ * When the ring is full the tail is advanced before the oldest slot is
+ * overwritten, and head is published only after the slot is complete, so
+ * a reader (or a post-crash recovery) never sees a half-written record
+ * inside [tail, head).
+ */
+void MappedRingLogSink::write(const LogRecord& record) {
+    const std::uint64_t capacity = header->capacity;
+    const std::uint64_t head = header->head.load(std::memory_order_relaxed);
+    if (head - header->tail.load(std::memory_order_relaxed) >= capacity) {
+        header->tail.store(head - capacity + 1, std::memory_order_release);
+    }
+    slots[head % capacity] = encodeJournalRecord(record);
+    header->head.store(head + 1, std::memory_order_release);
+    written++;
+}
+
+void MappedRingLogSink::flush() {
+    if (header != nullptr) {
+        ::msync(header, mappedBytes, MS_ASYNC);
+    }
+}
+
+LogWriterStats MappedRingLogSink::stats() const {
+    LogWriterStats result;
+    result.queued = written;
+    result.written = written;
+    return result;
+}
+
+bool readRingLog(const std::string& path,
+                 const std::function<void(const LogRecord&)>& callback,
+                 std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(RingLogHeader)) {
+        ::close(fd);
+        error = path + " is not a ring log";
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+
+    const RingLogHeader* header = static_cast<const RingLogHeader*>(mapping);
+    if (!headerMatches(header, 0) || header->capacity == 0 || ringFileSize(header->capacity) != size) {
+        ::munmap(mapping, size);
+        error = path + " is not a ring log";
+        return false;
+    }
+
+    const JournalRecord* slots = reinterpret_cast<const JournalRecord*>(
+        static_cast<const char*>(mapping) + sizeof(RingLogHeader));
+    const std::uint64_t capacity = header->capacity;
+    const std::uint64_t head = header->head.load(std::memory_order_acquire);
+    std::uint64_t first = header->tail.load(std::memory_order_acquire);
+    if (head - first > capacity) {
+        first = head - capacity;
+    }
+
+    std::vector<JournalRecord> copy(static_cast<std::size_t>(head - first));
+    for (std::uint64_t seq = first; seq < head; seq++) {
+        copy[static_cast<std::size_t>(seq - first)] = slots[seq % capacity];
+    }
+
+    // A live writer may have overwritten the oldest slots while copying
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t tailAfter = header->tail.load(std::memory_order_acquire);
+    ::munmap(mapping, size);
+
+    for (std::uint64_t seq = (tailAfter > first ? tailAfter : first); seq < head; seq++) {
+        callback(decodeJournalRecord(copy[static_cast<std::size_t>(seq - first)]));
+    }
+    return true;
+}
@@ -0,0 +1,303 @@
+#include "labelm_rotation.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#ifdef LABELM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "labelm_logindex.h"
+
+namespace {
+
+/// Splits `dir/production_log.txt` into `dir/`, `production_log` and `.txt`
+void splitPath(const std::string& path, std::string& dir, std::string& stem, std::string& ext) {
+    const std::size_t slash = path.find_last_of('/');
+    dir = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    const std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    const std::size_t dot = name.find_last_of('.');
+    stem = dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+    ext = dot == std::string::npos || dot == 0 ? std::string() : name.substr(dot);
+}
+
+/**
+ * @brief gzip-compresses a closed segment to `<path>.gz` and removes the original
+ * @return true if the segment was replaced by its compressed form
+ */
+bool compressSegment(const std::string& path) {
+#ifdef LABELM_HAVE_ZLIB
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (in == nullptr) {
+        return false;
+    }
+    const std::string temporary = path + ".gz.tmp";
+    gzFile out = gzopen(temporary.c_str(), "wb6");
+    if (out == nullptr) {
+        std::fclose(in);
+        return false;
+    }
+    static thread_local char buffer[1 << 16];
+    bool ok = true;
+    std::size_t length;
+    while (ok && (length = std::fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        ok = gzwrite(out, buffer, static_cast<unsigned>(length)) == static_cast<int>(length);
+    }
+    ok = ok && !std::ferror(in);
+    std::fclose(in);
+    ok = gzclose(out) == Z_OK && ok;
+    if (!ok || std::rename(temporary.c_str(), (path + ".gz").c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    std::remove(path.c_str());
+    // Byte offsets of the index refer to the uncompressed file
+    std::remove(logIndexPath(path).c_str());
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void removeSegment(const LogSegment& segment) {
+    std::remove(segment.path.c_str());
+    if (!segment.compressed) {
+        std::remove(logIndexPath(segment.path).c_str());
+    }
+}
+
+} // namespace
+
+std::string logSegmentPath(const std::string& basePath, std::uint64_t number) {
+    std::string dir, stem, ext;
+    splitPath(basePath, dir, stem, ext);
+    char digits[24];
+    std::snprintf(digits, sizeof(digits), "-%06llu", static_cast<unsigned long long>(number));
+    return dir + stem + digits + ext;
+}
+
+std::vector<LogSegment> listLogSegments(const std::string& basePath) {
+    std::string dir, stem, ext;
+    splitPath(basePath, dir, stem, ext);
+    std::vector<LogSegment> segments;
+    DIR* handle = ::opendir(dir.empty() ? "." : dir.c_str());
+    if (handle == nullptr) {
+        return segments;
+    }
+    const std::string prefix = stem + "-";
+    while (const dirent* entry = ::readdir(handle)) {
+        const std::string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        // <stem>-<digits><ext>[.gz]
+        std::size_t pos = prefix.size();
+        const std::size_t digitsStart = pos;
+        while (pos < name.size() && name[pos] >= '0' && name[pos] <= '9') {
+            pos++;
+        }
+        if (pos == digitsStart) {
+            continue;
+        }
+        const std::string rest = name.substr(pos);
+        const bool compressed = rest == ext + ".gz";
+        if (rest != ext && !compressed) {
+            continue;
+        }
+        segments.push_back(LogSegment{std::strtoull(name.c_str() + digitsStart, nullptr, 10), dir + name, compressed});
+    }
+    ::closedir(handle);
+    std::sort(segments.begin(), segments.end(),
+              [](const LogSegment& a, const LogSegment& b) { return a.number < b.number; });
+    return segments;
+}
+
+RotatingCsvLogSink::RotatingCsvLogSink(const std::string& basePath, const LogRotationOptions& rotation,
+                                       std::size_t indexInterval)
+    : basePath(basePath)
+    , rotation(rotation)
+    , indexInterval(indexInterval)
+{
+    // Continue after the newest segment of earlier sessions
+    const std::vector<LogSegment> existing = listLogSegments(basePath);
+    activeNumber = existing.empty() ? 1 : existing.back().number + 1;
+    active = openSegment(activeNumber);
+    if (!active || !active->isOpen()) {
+        return;
+    }
+    nextNumber = activeNumber + 1;
+    pruneBelow = activeNumber;
+    worker = std::thread(&RotatingCsvLogSink::housekeeping, this);
+}
+
+RotatingCsvLogSink::~RotatingCsvLogSink() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    active.reset();
+    if (next) {
+        // Never used: remove it so sessions do not leave empty segments behind
+        const std::uint64_t unused = activeNumber + 1;
+        next.reset();
+        removeSegment(LogSegment{unused, logSegmentPath(basePath, unused), false});
+    }
+}
+
+std::unique_ptr<CsvLogSink> RotatingCsvLogSink::openSegment(std::uint64_t number) const {
+    return std::unique_ptr<CsvLogSink>(new CsvLogSink(logSegmentPath(basePath, number), false, indexInterval));
+}
+
+bool RotatingCsvLogSink::isOpen() const {
+    return active && active->isOpen();
+}
+
+void RotatingCsvLogSink::write(const LogRecord& record) {
+    if (!segmentStarted) {
+        segmentStartNs = record.timestampNs;
+        segmentStarted = true;
+    }
+    const bool sizeDue = rotation.maxBytes > 0 && active->bytes() >= rotation.maxBytes;
+    const bool ageDue = rotation.maxAge.count() > 0
+                        && record.timestampNs - segmentStartNs >= std::chrono::nanoseconds(rotation.maxAge).count();
+    if ((sizeDue || ageDue) && active->stats().written > 0) {
+        rotate(record.timestampNs);
+    }
+    active->write(record);
+}
+
+/**
+ * @brief Swaps in the pre-created segment and hands the old one to the housekeeper
+ *
+ * Only falls back to creating the segment here if the housekeeper has not
+ * started preparing it (e.g. two rotations in quick succession). A segment
+ * file is opened (truncated) by one thread only: whoever claims its number
+ * first; if the housekeeper is opening it right now, this waits for it.
+ */
+void RotatingCsvLogSink::rotate(std::int64_t timestampNs) {
+    const std::uint64_t number = activeNumber + 1;
+    std::unique_ptr<CsvLogSink> fresh;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        opened.wait(lock, [this, number] { return claimed != number; });
+        fresh = std::move(next);
+        if (!fresh) {
+            claimed = number;
+        }
+    }
+    if (!fresh) {
+        fresh = openSegment(number);
+    }
+    if (!fresh->isOpen()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        claimed = 0;
+        return;     // Keep writing to the current segment
+    }
+
+    writtenBefore += active->stats().written;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        claimed = 0;
+        retired.push_back(std::move(active));
+        closedNumbers.push_back(activeNumber);
+        activeNumber++;
+        nextNumber = activeNumber + 1;
+        pruneBelow = activeNumber;
+        active = std::move(fresh);
+    }
+    wake.notify_one();
+    segmentStartNs = timestampNs;
+}
+
+void RotatingCsvLogSink::flush() {
+    active->flush();
+}
+
+LogWriterStats RotatingCsvLogSink::stats() const {
+    LogWriterStats result;
+    result.written = writtenBefore + (active ? active->stats().written : 0);
+    result.queued = result.written;
+    return result;
+}
+
+/**
+ * @brief Deletes the oldest closed segments beyond keepSegments
+ */
+void RotatingCsvLogSink::pruneSegments(std::uint64_t activeNumber) {
+    if (rotation.keepSegments == 0) {
+        return;
+    }
+    std::vector<LogSegment> closed;
+    for (const LogSegment& segment : listLogSegments(basePath)) {
+        if (segment.number < activeNumber) {
+            closed.push_back(segment);
+        }
+    }
+    if (closed.size() <= rotation.keepSegments) {
+        return;
+    }
+    const std::size_t excess = closed.size() - rotation.keepSegments;
+    for (std::size_t i = 0; i < excess; i++) {
+        removeSegment(closed[i]);
+    }
+}
+
+/**
+ * @brief Housekeeping thread: closes, compresses and prunes segments and pre-creates the next one
+ */
+void RotatingCsvLogSink::housekeeping() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] {
+            return stopping || !retired.empty() || nextNumber != 0 || pruneBelow != 0;
+        });
+        std::vector<std::unique_ptr<CsvLogSink>> closing = std::move(retired);
+        retired.clear();
+        std::vector<std::uint64_t> compressing = std::move(closedNumbers);
+        closedNumbers.clear();
+        const std::uint64_t prepare = stopping ? 0 : nextNumber;
+        nextNumber = 0;
+        const std::uint64_t prune = pruneBelow;
+        pruneBelow = 0;
+        const bool exit = stopping;
+        lock.unlock();
+
+        // Destroying a sink flushes and closes its file and index
+        closing.clear();
+        if (rotation.compress) {
+            for (std::uint64_t number : compressing) {
+                compressSegment(logSegmentPath(basePath, number));
+            }
+        }
+        if (prune != 0) {
+            pruneSegments(prune);
+        }
+
+        lock.lock();
+        // Only open the segment if it is still the next one and rotate() has not claimed it
+        if (prepare != 0 && prepare == activeNumber + 1 && !next && claimed == 0) {
+            claimed = prepare;
+            lock.unlock();
+            std::unique_ptr<CsvLogSink> prepared = openSegment(prepare);
+            lock.lock();
+            if (prepared->isOpen()) {
+                next = std::move(prepared);
+            }
+            claimed = 0;
+            opened.notify_all();
+        }
+        if (exit) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include "labelm_scheduler.h"
+
+#include "labelmachine.h"
+
+EventScheduler::EventScheduler(SimulationClock& clock)
+    : clock(clock)
+{
+}
+
+void EventScheduler::scheduleAt(std::int64_t timeNs, ScheduledEventType type, std::int32_t value) {
+    queue.push(ScheduledEvent{timeNs, nextSequence++, type, value, nullptr});
+}
+
+void EventScheduler::scheduleAfter(std::chrono::nanoseconds delay, ScheduledEventType type, std::int32_t value) {
+    scheduleAt(clock.nowNs() + delay.count(), type, value);
+}
+
+void EventScheduler::scheduleCallback(std::int64_t timeNs, std::function<void(LabelingMachine&)> callback) {
+    queue.push(ScheduledEvent{timeNs, nextSequence++, ScheduledEventType::CALLBACK, 0, std::move(callback)});
+}
+
+void EventScheduler::scheduleProducts(std::int64_t firstArrivalNs, std::size_t count,
+                                      std::chrono::nanoseconds interval, std::chrono::nanoseconds dwell) {
+    for (std::size_t i = 0; i < count; i++) {
+        const std::int64_t arrival = firstArrivalNs + static_cast<std::int64_t>(i) * interval.count();
+        scheduleAt(arrival, ScheduledEventType::PRODUCT_ARRIVAL);
+        scheduleAt(arrival + dwell.count(), ScheduledEventType::PRODUCT_EXIT);
+    }
+}
+
+std::size_t EventScheduler::runUntil(LabelingMachine& machine, std::int64_t endNs) {
+    std::size_t executed = 0;
+    while (!queue.empty() && queue.top().timeNs <= endNs) {
+        // Copy out before pop: the callback may schedule new events
+        ScheduledEvent event = queue.top();
+        queue.pop();
+        clock.advanceTo(event.timeNs);
+        execute(machine, event);
+        executed++;
+    }
+    clock.advanceTo(endNs);
+    return executed;
+}
+
+std::size_t EventScheduler::runAll(LabelingMachine& machine) {
+    std::size_t executed = 0;
+    while (!queue.empty()) {
+        executed += runUntil(machine, queue.top().timeNs);
+    }
+    return executed;
+}
+
+void EventScheduler::execute(LabelingMachine& machine, const ScheduledEvent& event) {
+    switch (event.type) {
+        case ScheduledEventType::PRODUCT_ARRIVAL: machine.detectProduct(true); break;
+        case ScheduledEventType::PRODUCT_EXIT:    machine.detectProduct(false); break;
+        case ScheduledEventType::START:           machine.start(); break;
+        case ScheduledEventType::STOP:            machine.stop(); break;
+        case ScheduledEventType::PAUSE:           machine.pause(); break;
+        case ScheduledEventType::RESUME:          machine.resume(); break;
+        case ScheduledEventType::ROLL_CHANGE:     machine.loadLabelRoll(event.value); break;
+        case ScheduledEventType::SET_SPEED:       machine.setSpeed(event.value); break;
+        case ScheduledEventType::CALLBACK:
+            if (event.callback) {
+                event.callback(machine);
+            }
+            break;
+    }
+}
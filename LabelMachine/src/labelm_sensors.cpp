@@ -0,0 +1,183 @@
+#include "labelm_sensors.h"
+
+#include <algorithm>
+
+#include "labelmachine.h"
+
+namespace {
+
+std::size_t ingestionLatencyBucket(std::uint64_t ns) {
+    std::size_t bucket = 0;
+    while (ns > 1 && bucket + 1 < SensorIngestionStats::LATENCY_BUCKETS) {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+} // namespace
+
+std::uint64_t SensorIngestionStats::latencyPercentileNs(double fraction) const {
+    if (labeled == 0) {
+        return 0;
+    }
+    const std::uint64_t rank = static_cast<std::uint64_t>(fraction * (labeled - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += latencyBuckets[i];
+        if (seen >= rank) {
+            return std::min<std::uint64_t>((std::uint64_t(2) << i) - 1, latencyMaxNs);
+        }
+    }
+    return latencyMaxNs;
+}
+
+bool SensorProducer::push(const SensorDelta& delta) {
+    if (ring.tryPush(delta)) {
+        received.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool SensorProducer::productDetected(bool detected) {
+    return push(SensorDelta{monotonicTimeNs(), 0.0,
+                            detected ? SensorDeltaType::PRODUCT_DETECTED : SensorDeltaType::PRODUCT_CLEARED});
+}
+
+bool SensorProducer::temperature(double celsius) {
+    return push(SensorDelta{monotonicTimeNs(), celsius, SensorDeltaType::TEMPERATURE});
+}
+
+SensorIngestion::SensorIngestion(LabelingMachine& machine, const SensorIngestionOptions& options)
+    : machine(machine)
+    , options(options)
+{
+    const std::size_t count = std::max<std::size_t>(1, options.producerCount);
+    producers.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        producers.push_back(std::make_unique<SensorProducer>(options.ringCapacity));
+    }
+    batch.reserve(count * std::max<std::size_t>(1, options.batchSize));
+}
+
+SensorIngestion::~SensorIngestion() {
+    stop();
+}
+
+bool SensorIngestion::start() {
+    if (worker.joinable()) {
+        return false;
+    }
+    stopping.store(false, std::memory_order_release);
+    worker = std::thread(&SensorIngestion::run, this);
+    return true;
+}
+
+void SensorIngestion::stop() {
+    stopping.store(true, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Collects one batch from all rings and applies it in capture order
+ *
+ * Taking at most batchSize deltas per ring keeps one busy producer from
+ * starving the others; sorting merges the rings into a single timeline.
+ */
+std::size_t SensorIngestion::drain() {
+    const std::size_t perRing = std::max<std::size_t>(1, options.batchSize);
+    batch.clear();
+    SensorDelta delta;
+    for (const std::unique_ptr<SensorProducer>& producer : producers) {
+        for (std::size_t i = 0; i < perRing && producer->ring.tryPop(delta); i++) {
+            batch.push_back(delta);
+        }
+    }
+    if (batch.empty()) {
+        return 0;
+    }
+    if (producers.size() > 1) {
+        std::stable_sort(batch.begin(), batch.end(),
+                         [](const SensorDelta& a, const SensorDelta& b) { return a.captureNs < b.captureNs; });
+    }
+    for (const SensorDelta& item : batch) {
+        apply(item);
+    }
+
+    const std::uint64_t count = batch.size();
+    applied.fetch_add(count, std::memory_order_relaxed);
+    batches.fetch_add(1, std::memory_order_relaxed);
+    if (count > maxBatch.load(std::memory_order_relaxed)) {
+        maxBatch.store(count, std::memory_order_relaxed);
+    }
+    return batch.size();
+}
+
+void SensorIngestion::apply(const SensorDelta& delta) {
+    switch (delta.type) {
+        case SensorDeltaType::PRODUCT_DETECTED: {
+            const int before = machine.getProductionCount();
+            machine.detectProduct(true);
+            if (machine.getProductionCount() != before) {
+                const std::int64_t elapsed = monotonicTimeNs() - delta.captureNs;
+                const std::uint64_t ns = elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0;
+                labeled.fetch_add(1, std::memory_order_relaxed);
+                latencyTotalNs.fetch_add(ns, std::memory_order_relaxed);
+                if (ns > latencyMaxNs.load(std::memory_order_relaxed)) {
+                    latencyMaxNs.store(ns, std::memory_order_relaxed);
+                }
+                latencyBuckets[ingestionLatencyBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        }
+        case SensorDeltaType::PRODUCT_CLEARED:
+            machine.detectProduct(false);
+            break;
+        case SensorDeltaType::TEMPERATURE:
+            machine.updateTemperature(delta.value);
+            break;
+    }
+}
+
+SensorIngestionStats SensorIngestion::stats() const {
+    SensorIngestionStats result;
+    for (const std::unique_ptr<SensorProducer>& producer : producers) {
+        result.received += producer->received.load(std::memory_order_relaxed);
+        result.dropped += producer->dropped.load(std::memory_order_relaxed);
+    }
+    result.applied = applied.load(std::memory_order_relaxed);
+    result.batches = batches.load(std::memory_order_relaxed);
+    result.maxBatch = maxBatch.load(std::memory_order_relaxed);
+    result.labeled = labeled.load(std::memory_order_relaxed);
+    result.latencyTotalNs = latencyTotalNs.load(std::memory_order_relaxed);
+    result.latencyMaxNs = latencyMaxNs.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < SensorIngestionStats::LATENCY_BUCKETS; i++) {
+        result.latencyBuckets[i] = latencyBuckets[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+/**
+ * @brief Control thread main loop
+ *
+ * Drains until stop() is requested, then once more so no delta pushed
+ * before stop() is lost. Every pass also takes over the setpoint of a
+ * running speed ramp, so the conveyor follows it between products.
+ */
+void SensorIngestion::run() {
+    for (;;) {
+        const bool stopRequested = stopping.load(std::memory_order_acquire);
+        const std::size_t count = drain();
+        machine.updateSpeedRamp();
+        if (stopRequested && count == 0) {
+            break;
+        }
+        if (count == 0) {
+            std::this_thread::sleep_for(options.idleWait);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#include "labelm_stats.h"
+
+void ProductionStats::reset(std::int64_t nowNs, MachineState state) {
+    sessionStartNs = nowNs;
+    stateSinceNs = nowNs;
+    currentState = state;
+    closedStateNs.fill(0);
+    labelsApplied = 0;
+    labelFailures = 0;
+    transitions = 0;
+}
+
+void ProductionStats::onTransition(MachineState from, MachineState to, std::int64_t nowNs) {
+    // A clock that went backwards contributes nothing rather than negative time
+    if (nowNs > stateSinceNs) {
+        closedStateNs[static_cast<std::size_t>(from)] += nowNs - stateSinceNs;
+        stateSinceNs = nowNs;
+    }
+    currentState = to;
+    transitions++;
+}
+
+ProductionStatistics ProductionStats::snapshot(std::int64_t nowNs) const {
+    ProductionStatistics result;
+    result.sessionStartNs = sessionStartNs;
+    result.sessionNs = nowNs > sessionStartNs ? nowNs - sessionStartNs : 0;
+    result.timeInStateNs = closedStateNs;
+    if (nowNs > stateSinceNs) {
+        result.timeInStateNs[static_cast<std::size_t>(currentState)] += nowNs - stateSinceNs;
+    }
+    result.labelsApplied = labelsApplied;
+    result.labelFailures = labelFailures;
+    result.transitions = transitions;
+
+    const std::int64_t labelingNs = result.timeIn(MachineState::RUNNING) + result.timeIn(MachineState::LOW_LABEL);
+    const std::int64_t productionNs = labelingNs + result.timeIn(MachineState::PAUSED)
+                                      + result.timeIn(MachineState::ERROR);
+    if (labelingNs > 0) {
+        result.labelsPerMinute = labelsApplied * 60e9 / labelingNs;
+    }
+    if (productionNs > 0) {
+        result.efficiency = static_cast<double>(labelingNs) / productionNs;
+    }
+    const std::uint64_t attempts = labelsApplied + labelFailures;
+    if (attempts > 0) {
+        result.successRate = static_cast<double>(labelsApplied) / attempts;
+    }
+    return result;
+}
@@ -0,0 +1,135 @@
+#include "labelm_status.h"
+
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::string statusBlockName(const std::string& machineId) {
+    std::string name = "/labelm-status-";
+    for (char c : machineId) {
+        const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                             || c == '-' || c == '_';
+        name += allowed ? c : '_';
+    }
+    return name;
+}
+
+StatusPublisher::StatusPublisher(const std::string& name)
+    : name(name)
+{
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        return;
+    }
+    // Start from zero: a block left by a crashed process may be mid-write
+    if (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, sizeof(StatusBlock)) != 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return;
+    }
+    void* mapping = ::mmap(nullptr, sizeof(StatusBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        return;
+    }
+    block = new (mapping) StatusBlock();
+    std::memcpy(block->header.magic, STATUS_BLOCK_MAGIC, sizeof(block->header.magic));
+    block->header.version = STATUS_BLOCK_VERSION;
+    block->header.snapshotSize = sizeof(MachineStatusSnapshot);
+    block->header.online.store(1, std::memory_order_release);
+}
+
+StatusPublisher::~StatusPublisher() {
+    if (block == nullptr) {
+        return;
+    }
+    block->header.online.store(0, std::memory_order_release);
+    ::munmap(block, sizeof(StatusBlock));
+    // Readers that still have it mapped keep the offline block
+    ::shm_unlink(name.c_str());
+}
+
+void StatusPublisher::publish(MachineStatusSnapshot snapshot) {
+    if (block == nullptr) {
+        return;
+    }
+    snapshot.publishCount = ++published;
+    std::uint64_t words[STATUS_SNAPSHOT_WORDS];
+    std::memcpy(words, &snapshot, sizeof(words));
+
+    // Seqlock write: odd sequence, data, even sequence
+    const std::uint64_t sequence = block->header.sequence.load(std::memory_order_relaxed);
+    block->header.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < STATUS_SNAPSHOT_WORDS; i++) {
+        block->words[i].store(words[i], std::memory_order_relaxed);
+    }
+    block->header.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+StatusReader::StatusReader(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(StatusBlock)) {
+        ::close(fd);
+        return;
+    }
+    void* mapping = ::mmap(nullptr, sizeof(StatusBlock), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return;
+    }
+    const StatusBlock* candidate = static_cast<const StatusBlock*>(mapping);
+    if (std::memcmp(candidate->header.magic, STATUS_BLOCK_MAGIC, sizeof(candidate->header.magic)) != 0
+        || candidate->header.version != STATUS_BLOCK_VERSION
+        || candidate->header.snapshotSize != sizeof(MachineStatusSnapshot)) {
+        ::munmap(mapping, sizeof(StatusBlock));
+        return;
+    }
+    block = candidate;
+}
+
+StatusReader::~StatusReader() {
+    if (block != nullptr) {
+        ::munmap(const_cast<StatusBlock*>(block), sizeof(StatusBlock));
+    }
+}
+
+bool StatusReader::isOnline() const {
+    return block != nullptr && block->header.online.load(std::memory_order_acquire) != 0;
+}
+
+bool StatusReader::read(MachineStatusSnapshot& snapshot, int maxAttempts) const {
+    if (block == nullptr) {
+        return false;
+    }
+    std::uint64_t words[STATUS_SNAPSHOT_WORDS];
+    for (int attempt = 0; attempt < maxAttempts; attempt++) {
+        const std::uint64_t before = block->header.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();  // Write in progress
+            continue;
+        }
+        for (std::size_t i = 0; i < STATUS_SNAPSHOT_WORDS; i++) {
+            words[i] = block->words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block->header.sequence.load(std::memory_order_relaxed) == before) {
+            if (before == 0) {
+                return false;   // Nothing published yet
+            }
+            std::memcpy(&snapshot, words, sizeof(snapshot));
+            return true;
+        }
+    }
+    return false;
+}
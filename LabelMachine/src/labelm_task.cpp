@@ -1,5 +1,9 @@
 #include "labelmachine.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
 /**
  * @brief Resumes the labeling machine operation
  *
@@ -15,35 +19,32 @@
  * - If Label is not available, transitions machine to IDLE state
  */
 bool LabelingMachine::resume() {
-    if (state != MachineState::PAUSED) {
-        std::cout << "[WARNING] Cannot resume machine - not in PAUSED state\n";
+    OperationTimer timer(latency.get(), MetricOperation::RESUME);
+    TraceSpan span(trace.get(), "resume");
+    if (!isTransitionLegal(state, StateEvent::RESUME)) {
+        emitEvent(EventCode::RESUME_REJECTED);
         return false;
     }
 
     if (!isTemperatureSafe()) {
-        std::cout << "[ERROR] Cannot start - temperature too high: "
-                    << sensors.temperature << "°C\n";
-        state = MachineState::ERROR;
+        transition(StateEvent::FAULT);
+        emitEvent(EventCode::RESUME_OVER_TEMPERATURE, 0, 0, 0, sensors.temperature);
         return false;
     }
 
     if (sensors.labelRollRemaining == 0) {
-        std::cout << "[WARNING] Cannot resume - no labels available. To IDLE state.\n";
-        previousState = state;
-        state = MachineState::IDLE;
+        transition(StateEvent::STOP);
+        emitEvent(EventCode::RESUME_NO_LABELS);
         return false;
     }
 
-    MachineState cstate = state;
-    state = previousState;
-    previousState = cstate;
+    transition(StateEvent::RESUME);
     sensors = previousSensors;
     if (isLowerLabels()) {
-        std::cout << "[WARNING] Low label warning - Labels remaining: "
-                  << sensors.labelRollRemaining << "\n";
-        state = MachineState::LOW_LABEL;
-    } 
-    std::cout << "[INFO] Machine resumed - Speed: " << sensors.conveyorSpeed << " mm/s\n";
+        transition(StateEvent::LABELS_LOW);
+        emitEvent(EventCode::LOW_LABEL_WARNING, sensors.labelRollRemaining);
+    }
+    emitEvent(EventCode::RESUMED, sensors.conveyorSpeed);
     return true;
 }
 
@@ -54,18 +55,14 @@ bool LabelingMachine::resume() {
  * Can be called from RUNNING state.
  */
 bool LabelingMachine::pause() {
-    if (state != MachineState::RUNNING && state != MachineState::LOW_LABEL) {
-        std::cout << "[WARNING] Cannot pause machine - not in RUNNING state\n";
+    OperationTimer timer(latency.get(), MetricOperation::PAUSE);
+    TraceSpan span(trace.get(), "pause");
+    if (!transition(StateEvent::PAUSE)) {
+        emitEvent(EventCode::PAUSE_REJECTED);
         return false;
     }
 
-    previousState = state;
-    state = MachineState::PAUSED;
-    previousSensors = sensors;
-    sensors.conveyorSpeed = 0;
-    std::cout << "[INFO] Machine paused - Total labeled: "
-                << productsLabeled << " - Remaining labels: " 
-                << sensors.labelRollRemaining << "\n";
+    emitEvent(EventCode::PAUSED, productsLabeled, sensors.labelRollRemaining);
     return true;
 }
 
@@ -76,15 +73,14 @@ bool LabelingMachine::pause() {
  * Can be called from IDLE state.
  */
 bool LabelingMachine::enterMaintenance() {
-    if (state != MachineState::IDLE) {
-        std::cout << "[WARNING] Cannot enter maintenance machine - not in IDLE state\n";
+    OperationTimer timer(latency.get(), MetricOperation::ENTER_MAINTENANCE);
+    TraceSpan span(trace.get(), "enterMaintenance");
+    if (!transition(StateEvent::ENTER_MAINTENANCE)) {
+        emitEvent(EventCode::MAINTENANCE_ENTER_REJECTED);
         return false;
     }
 
-    previousState = MachineState::IDLE;
-    state = MachineState::MAINTENANCE;
-    sensors.conveyorSpeed = config.maintenanceSpeed;
-    std::cout << "[INFO] Machine in maintenance." << "\n";
+    emitEvent(EventCode::MAINTENANCE_ENTERED);
     return true;
 }
 
@@ -100,66 +96,258 @@ bool LabelingMachine::enterMaintenance() {
  * - Machine must be in MAINTENANCE state
  */
 bool LabelingMachine::exitMaintenance() {
-    if (state != MachineState::MAINTENANCE) {
-        std::cout << "[WARNING] Cannot exit maintenance mode - not in MAIINTENANCE state\n";
+    OperationTimer timer(latency.get(), MetricOperation::EXIT_MAINTENANCE);
+    TraceSpan span(trace.get(), "exitMaintenance");
+    if (!transition(StateEvent::EXIT_MAINTENANCE)) {
+        emitEvent(EventCode::MAINTENANCE_EXIT_REJECTED);
         return false;
     }
-    previousState = state;
-    state = MachineState::IDLE;
-    sensors.conveyorSpeed = 0;
-    std::cout << "[INFO] Machine exited from maintenance mode. Ready for operation.\n";
+    emitEvent(EventCode::MAINTENANCE_EXITED);
     return true;
 }
 
+/**
+ * @brief Gets the current local time as `YYYY-MM-DD HH:MM:SS`
+ *
+ * Uses the machine's cached TimestampFormatter; prefer
+ * getCurrentTime(char*, size_t) on hot paths to avoid the string.
+ */
 std::string LabelingMachine::getCurrentTime() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    std::tm* parts = std::localtime(&now_c);
-    if(!parts) {
-        return "0000-00-00 00:00:00"; // Fallback in case of error
-    }
+    char buffer[TimestampFormatter::BUFFER_SIZE];
+    std::size_t length = getCurrentTime(buffer, sizeof(buffer));
+    return std::string(buffer, length);
+}
 
-    std::stringstream ss;
-    ss << std::put_time(parts, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+std::size_t LabelingMachine::getCurrentTime(char* buffer, std::size_t size, bool withMillis) {
+    return timestampFormatter.format(clock->nowNs(), buffer, size, withMillis);
 }
 
-void LabelingMachine::openLog() {
-    // Open log file
-    logFile.open(LOG_FILE_NAME, std::ios::out | std::ios::trunc);
+/**
+ * @brief Opens the production log and starts the logger thread
+ *
+ * Any previously open log is closed (and drained) first.
+ */
+void LabelingMachine::openLog(const LogOptions& options) {
+    closeLog();
+    logDisabled = options.format == LogFormat::DISABLED;
 
-    if (!logFile) {
-        std::cerr << "[ERROR] Failed to open log file: " << LOG_FILE_NAME << "\n";
+    // Open log file; the header is written by the sink
+    std::unique_ptr<LogSink> sink;
+    switch (options.format) {
+        case LogFormat::CSV:
+            logPath = options.path.empty() ? LOG_FILE_NAME : options.path;
+            if (options.rotation.enabled()) {
+                sink.reset(new RotatingCsvLogSink(logPath, options.rotation, options.indexEveryRows));
+            } else {
+                sink.reset(new CsvLogSink(logPath, options.append, options.indexEveryRows));
+            }
+            break;
+        case LogFormat::BINARY_JOURNAL:
+            logPath = options.path.empty() ? JOURNAL_FILE_NAME : options.path;
+            sink.reset(new BinaryJournalSink(logPath));
+            break;
+        case LogFormat::MAPPED_RING:
+            logPath = options.path.empty() ? RING_LOG_FILE_NAME : options.path;
+            sink.reset(new MappedRingLogSink(logPath, options.ringCapacity));
+            break;
+        case LogFormat::DISABLED:
+            logPath.clear();
+            return;
+    }
+    if (!sink || !sink->isOpen()) {
+        emitEvent(EventCode::LOG_OPEN_FAILED, 0, 0, 0, 0.0, logPath.c_str());
+        return;
     }
 
-    // Write the CSV header row
-    logFile << "Timestamp,ProductID,Temperature,Speed,Status\n";
-    logFile.flush();
-    std::cout << "[INFO] Log file initialized and header written on: " << LOG_FILE_NAME << "\n";
+    if (options.format == LogFormat::MAPPED_RING) {
+        // Ring writes are plain memory stores; no logger thread needed
+        logSink = std::move(sink);
+    } else {
+        AsyncLogOptions async = options.async;
+        async.trace = trace.get();
+        logSink.reset(new AsyncLogWriter(std::move(sink), async));
+    }
+    emitEvent(EventCode::LOG_OPENED, 0, 0, 0, 0.0, logPath.c_str());
 }
 
 void LabelingMachine::logEntry(const std::string& status) {
-    if (!logFile.is_open()) {
-        std::cerr << "[ERROR] Log file not open. Cannot log entry.\n";
+    logEntry(status == "FAILURE" ? LogStatus::FAILURE : LogStatus::SUCCESS);
+}
+
+void LabelingMachine::logEntry(LogStatus status) {
+    OperationTimer timer(latency.get(), MetricOperation::LOG_ENTRY);
+    if (!logSink) {
+        if (!logDisabled) {
+            emitEvent(EventCode::LOG_NOT_OPEN);
+        }
         return;
     }
-    int productId = productsLabeled; // Using productsLabeled as ProductID
-    if(status == "FAILURE") {
-        productId = productsLabeled + 1; // Next product ID for failure
+    LogRecord record;
+    record.timestampNs = clock->nowNs();
+    record.productId = productsLabeled; // Using productsLabeled as ProductID
+    if (status == LogStatus::FAILURE) {
+        record.productId = productsLabeled + 1; // Next product ID for failure
     }
-    std::string timestamp = getCurrentTime();
-    logFile << timestamp << ","
-            << productId << ","
-            << std::fixed << std::setprecision(1) << sensors.temperature << ","
-            << sensors.conveyorSpeed << ","
-            << status << "\n";
-    logFile.flush();
+    record.conveyorSpeed = sensors.conveyorSpeed;
+    record.temperature = sensors.temperature;
+    record.status = status;
+    record.state = state;
+    logSink->write(record);
 }
 
 void LabelingMachine::closeLog() {
-    if (logFile.is_open()) {
-        std::cout << "\n[INFO] Closing product log (" << LOG_FILE_NAME << ")\n";
-        std::cout << " Total products logged: " << productsLabeled << "\n";
-        logFile.close();
+    if (logSink) {
+        if (latency) {
+            emitLatencySummary();
+        }
+        emitEvent(EventCode::LOG_CLOSED, productsLabeled, 0, 0, 0.0, logPath.c_str());
+        // Destroying the writer drains the queue and joins the logger thread
+        logSink.reset();
+    }
+}
+
+void LabelingMachine::emitLatencySummary() {
+    // Event values are int; anything beyond ~2 s is reported as INT_MAX
+    auto clampNs = [](std::uint64_t ns) {
+        return static_cast<int>(std::min<std::uint64_t>(ns, std::numeric_limits<int>::max()));
+    };
+    for (std::size_t op = 0; op < METRIC_OPERATION_COUNT; op++) {
+        const MetricOperation operation = static_cast<MetricOperation>(op);
+        const LatencySummary summary = latency->summary(operation);
+        if (summary.count == 0) {
+            continue;
+        }
+        char detail[64];
+        std::snprintf(detail, sizeof(detail), "%s (%llu calls)", metricOperationName(operation),
+                      static_cast<unsigned long long>(summary.count));
+        emitEvent(EventCode::LATENCY_SUMMARY, clampNs(summary.p50Ns), clampNs(summary.p99Ns), clampNs(summary.p999Ns),
+                  static_cast<double>(summary.maxNs), detail);
+    }
+}
+
+bool LabelingMachine::startBatch(const std::string& batchId, int quantity) {
+    if (batches.isActive()) {
+        emitEvent(EventCode::BATCH_REJECTED, quantity, 0, 0, 0.0, "another batch is active");
+        return false;
+    }
+    if (quantity < 1) {
+        emitEvent(EventCode::BATCH_REJECTED, quantity, 0, 0, 0.0, "quantity must be positive");
+        return false;
+    }
+    WorkOrder order;
+    order.batchId = batchId;
+    order.quantity = quantity;
+    batches.begin(order);
+    emitEvent(EventCode::BATCH_STARTED, quantity, static_cast<int>(batches.pending()), 0, 0.0, batchId.c_str());
+    return true;
+}
+
+bool LabelingMachine::queueWorkOrder(const WorkOrder& order) {
+    if (order.quantity < 1 || order.rollLabels < 0) {
+        emitEvent(EventCode::BATCH_REJECTED, order.quantity, order.rollLabels, 0, 0.0, "invalid work order");
+        return false;
     }
-}
\ No newline at end of file
+    batches.enqueue(order);
+    emitEvent(EventCode::WORK_ORDER_QUEUED, order.quantity, static_cast<int>(batches.pending()), 0, 0.0,
+              order.batchId.c_str());
+    if (!batches.isActive()) {
+        advanceBatch();
+    }
+    return true;
+}
+
+bool LabelingMachine::cancelBatch() {
+    if (!batches.cancel()) {
+        return false;
+    }
+    const BatchProgress& cancelled = batches.current();
+    emitEvent(EventCode::BATCH_CANCELLED, cancelled.labeled, cancelled.quantity, 0, 0.0, cancelled.batchId.c_str());
+    advanceBatch();
+    return true;
+}
+
+bool LabelingMachine::cancelWorkOrder(const std::string& batchId) {
+    return batches.remove(batchId);
+}
+
+void LabelingMachine::advanceBatch() {
+    WorkOrder order;
+    if (!batches.popNext(order)) {
+        emitEvent(EventCode::BATCH_QUEUE_EMPTY);
+        return;
+    }
+    // Changeover: load the order's roll now rather than run out mid-batch
+    if (order.rollLabels > 0 && sensors.labelRollRemaining < order.quantity) {
+        loadLabelRoll(order.rollLabels);
+    }
+    batches.begin(order);
+    emitEvent(EventCode::BATCH_STARTED, order.quantity, static_cast<int>(batches.pending()), 0, 0.0,
+              order.batchId.c_str());
+}
+
+LogWriterStats LabelingMachine::getLogStats() const {
+    return logSink ? logSink->stats() : LogWriterStats();
+}
+
+bool LabelingMachine::restoreFromLog(const std::string& path, ReplaySummary* summary) {
+    if (state != MachineState::IDLE) {
+        emitEvent(EventCode::LOG_REPLAY_FAILED, 0, 0, 0, 0.0, "machine not idle");
+        return false;
+    }
+    std::string source = path.empty() ? (logPath.empty() ? LOG_FILE_NAME : logPath) : path;
+    if (logSink) {
+        // Rows queued by this session must be on disk before the file is read
+        logSink->sync();
+    }
+
+    ReplaySummary result;
+    std::string error;
+    bool replayed = false;
+    // Once the log has segments they hold the production history; a plain
+    // file from before rotation was enabled is stale
+    const std::vector<LogSegment> segments = path.empty() ? listLogSegments(source) : std::vector<LogSegment>();
+    if (segments.empty()) {
+        replayed = replayCsvLog(source, result, error);
+    } else {
+        // The newest segment with rows holds the latest state, the errors
+        // are the FAILURE rows of that segment and all before it
+        const auto replaySegment = [](const LogSegment& segment, ReplaySummary& summary, std::string& message) {
+            return segment.compressed ? replayCompressedCsvLog(segment.path, summary, message)
+                                      : replayCsvLog(segment.path, summary, message);
+        };
+        replayed = true;
+        source = segments.back().path;
+        std::size_t newest = segments.size();
+        while (newest > 0) {
+            ReplaySummary segmentResult;
+            std::string segmentError;
+            newest--;
+            if (replaySegment(segments[newest], segmentResult, segmentError) && segmentResult.rows > 0) {
+                source = segments[newest].path;
+                result = segmentResult;
+                break;
+            }
+        }
+        for (std::size_t i = 0; replayed && i < newest; i++) {
+            ReplaySummary earlier;
+            replayed = replaySegment(segments[i], earlier, error);
+            result.errorCount += static_cast<int>(earlier.failureRows);
+        }
+    }
+    if (!replayed) {
+        emitEvent(EventCode::LOG_REPLAY_FAILED, 0, 0, 0, 0.0, error.c_str());
+        return false;
+    }
+    if (result.rows > 0) {
+        productsLabeled = result.productsLabeled;
+        errorCount = result.errorCount;
+        sensors.temperature = result.lastTemperature;
+        publishStatus();
+    }
+    emitEvent(EventCode::LOG_REPLAYED, static_cast<int>(result.rows), result.productsLabeled,
+              result.errorCount, 0.0, source.c_str());
+    if (summary != nullptr) {
+        *summary = result;
+    }
+    return true;
+}
@@ -0,0 +1,156 @@
+#include "labelm_time.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+void putTwoDigits(char* out, int value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/// Reads `count` digits; returns -1 if any is not a digit
+int readDigits(const char* text, int count) {
+    int value = 0;
+    for (int i = 0; i < count; i++) {
+        if (!isDigit(text[i])) {
+            return -1;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return value;
+}
+
+} // namespace
+
+/**
+ * @brief Re-renders the cached minute prefix for the given epoch second
+ * @return false if the calendar conversion failed
+ */
+bool TimestampFormatter::refresh(std::int64_t second) {
+    std::time_t seconds = static_cast<std::time_t>(second);
+    std::tm parts;
+    lookups++;
+    if (localtime_r(&seconds, &parts) == nullptr) {
+        valid = false;
+        return false;
+    }
+    int written = std::snprintf(prefix, sizeof(prefix), "%04d-%02d-%02d %02d:%02d:",
+                                parts.tm_year + 1900, parts.tm_mon + 1, parts.tm_mday,
+                                parts.tm_hour, parts.tm_min);
+    if (written != static_cast<int>(PREFIX_LENGTH)) {
+        valid = false;
+        return false;
+    }
+    // tm_sec can be 60 on a leap second; keep the minute anchored at :00
+    minuteStart = second - (parts.tm_sec > 59 ? 59 : parts.tm_sec);
+    valid = true;
+    return true;
+}
+
+std::size_t TimestampFormatter::format(std::int64_t timestampNs, char* buffer, std::size_t size, bool withMillis) {
+    const std::size_t length = PREFIX_LENGTH + 2 + (withMillis ? 4 : 0);
+    if (buffer == nullptr || size <= length) {
+        return 0;
+    }
+
+    // Floor division so pre-epoch timestamps still land in the right second
+    std::int64_t second = timestampNs / 1000000000;
+    std::int64_t nanos = timestampNs % 1000000000;
+    if (nanos < 0) {
+        nanos += 1000000000;
+        second--;
+    }
+
+    if (!valid || second < minuteStart || second >= minuteStart + 60) {
+        if (!refresh(second)) {
+            std::memcpy(buffer, "0000-00-00 00:00:00", 20); // Fallback in case of error
+            return 19;
+        }
+    }
+
+    std::memcpy(buffer, prefix, PREFIX_LENGTH);
+    putTwoDigits(buffer + PREFIX_LENGTH, static_cast<int>(second - minuteStart));
+    if (withMillis) {
+        int millis = static_cast<int>(nanos / 1000000);
+        buffer[PREFIX_LENGTH + 2] = '.';
+        buffer[PREFIX_LENGTH + 3] = static_cast<char>('0' + millis / 100);
+        putTwoDigits(buffer + PREFIX_LENGTH + 4, millis % 100);
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Converts a new minute prefix with mktime() and caches it
+ * @return false if the prefix is malformed
+ */
+bool TimestampParser::refresh(const char* text) {
+    if (text[4] != '-' || text[7] != '-' || text[10] != ' ' || text[13] != ':' || text[16] != ':') {
+        return false;
+    }
+    std::tm parts = {};
+    parts.tm_year = readDigits(text, 4) - 1900;
+    parts.tm_mon = readDigits(text + 5, 2) - 1;
+    parts.tm_mday = readDigits(text + 8, 2);
+    parts.tm_hour = readDigits(text + 11, 2);
+    parts.tm_min = readDigits(text + 14, 2);
+    parts.tm_isdst = -1;
+    if (parts.tm_year < 0 || parts.tm_mon < 0 || parts.tm_mday < 0 || parts.tm_hour < 0 || parts.tm_min < 0) {
+        return false;
+    }
+    std::time_t seconds = std::mktime(&parts);
+    if (seconds == static_cast<std::time_t>(-1)) {
+        return false;
+    }
+    std::memcpy(prefix, text, PREFIX_LENGTH);
+    minuteStart = static_cast<std::int64_t>(seconds);
+    valid = true;
+    return true;
+}
+
+bool TimestampParser::parse(const char* text, std::size_t length, std::int64_t& timestampNs) {
+    if (text == nullptr || (length != PREFIX_LENGTH + 2 && length != PREFIX_LENGTH + 6)) {
+        return false;
+    }
+    if (!valid || std::memcmp(prefix, text, PREFIX_LENGTH) != 0) {
+        if (!refresh(text)) {
+            return false;
+        }
+    }
+    const int second = readDigits(text + PREFIX_LENGTH, 2);
+    if (second < 0 || second > 60) {
+        return false;
+    }
+    int millis = 0;
+    if (length == PREFIX_LENGTH + 6) {
+        millis = text[PREFIX_LENGTH + 2] == '.' ? readDigits(text + PREFIX_LENGTH + 3, 3) : -1;
+        if (millis < 0) {
+            return false;
+        }
+    }
+    timestampNs = (minuteStart + second) * 1000000000LL + millis * 1000000LL;
+    return true;
+}
+
+std::int64_t systemTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::int64_t monotonicTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const SystemClock& SystemClock::instance() {
+    static const SystemClock clock;
+    return clock;
+}
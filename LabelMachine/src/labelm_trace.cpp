@@ -0,0 +1,275 @@
+#include "labelm_trace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <pthread.h>
+
+namespace {
+
+/// Thread id of the machine state track in the written trace
+constexpr int STATE_TRACK_TID = 0;
+
+/// Last recorder used by this thread and its buffer there
+struct ThreadCache {
+    std::uint64_t serial = 0;
+    void* buffer = nullptr;
+};
+thread_local ThreadCache threadCache;
+
+std::uint64_t nextSerial() {
+    static std::atomic<std::uint64_t> serial{0};
+    return serial.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+const char* severityCategory(EventSeverity severity) {
+    switch (severity) {
+        case EventSeverity::DEBUG:   return "debug";
+        case EventSeverity::INFO:    return "info";
+        case EventSeverity::WARNING: return "warning";
+        case EventSeverity::ERROR:   return "error";
+        case EventSeverity::OFF:     break;
+    }
+    return "event";
+}
+
+/**
+ * @brief Appends a JSON string literal (quotes included)
+ */
+void appendJsonString(std::string& out, const char* text) {
+    out += '"';
+    for (const char* c = text; *c != '\0'; c++) {
+        switch (*c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(*c));
+                    out += escaped;
+                } else {
+                    out += *c;
+                }
+        }
+    }
+    out += '"';
+}
+
+/**
+ * @brief Appends one trace event object, followed by ",\n"
+ */
+void appendEvent(std::string& out, const TraceEvent& event, int tid) {
+    char buffer[160];
+    out += "{\"name\":";
+    appendJsonString(out, event.name != nullptr ? event.name : event.text);
+    out += ",\"cat\":";
+    appendJsonString(out, event.category);
+    if (event.durationNs >= 0) {
+        std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d},\n",
+                      event.startNs / 1000.0, event.durationNs / 1000.0, tid);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%d},\n",
+                      event.startNs / 1000.0, tid);
+    }
+    out += buffer;
+}
+
+void appendThreadName(std::string& out, int tid, const char* name) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", tid);
+    out += buffer;
+    appendJsonString(out, name);
+    out += "}},\n";
+}
+
+} // namespace
+
+TraceRecorder::TraceRecorder(std::size_t eventsPerThread)
+    : origin(std::chrono::steady_clock::now())
+    , capacity(eventsPerThread > 0 ? eventsPerThread : 1)
+    , serial(nextSerial())
+{}
+
+TraceRecorder::~TraceRecorder() {
+    for (std::atomic<ThreadBuffer*>& slot : buffers) {
+        delete slot.load(std::memory_order_acquire);
+    }
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::bufferOfThisThread() {
+    if (threadCache.serial == serial) {
+        return static_cast<ThreadBuffer*>(threadCache.buffer);
+    }
+    // This thread last recorded elsewhere (or never): find or claim its buffer
+    const std::thread::id self = std::this_thread::get_id();
+    ThreadBuffer* found = nullptr;
+    for (std::atomic<ThreadBuffer*>& slot : buffers) {
+        ThreadBuffer* buffer = slot.load(std::memory_order_acquire);
+        if (buffer == nullptr) {
+            ThreadBuffer* fresh = new ThreadBuffer();
+            fresh->owner = self;
+            fresh->events.reset(new TraceEvent[capacity]);
+            char name[32] = {};
+            if (pthread_getname_np(pthread_self(), name, sizeof(name)) != 0) {
+                name[0] = '\0';
+            }
+            fresh->threadName = name;
+            if (slot.compare_exchange_strong(buffer, fresh, std::memory_order_acq_rel)) {
+                found = fresh;
+                break;
+            }
+            delete fresh;   // Another thread claimed this slot first; buffer now holds it
+        }
+        if (buffer->owner == self) {
+            found = buffer;
+            break;
+        }
+    }
+    if (found != nullptr) {
+        threadCache.serial = serial;
+        threadCache.buffer = found;
+    }
+    return found;
+}
+
+TraceEvent* TraceRecorder::reserve(ThreadBuffer*& buffer) {
+    buffer = bufferOfThisThread();
+    if (buffer == nullptr) {
+        unbuffered.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    const std::size_t size = buffer->size.load(std::memory_order_relaxed);
+    if (size >= capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &buffer->events[size];
+}
+
+void TraceRecorder::span(const char* name, const char* category, std::int64_t startNs, std::int64_t endNs) {
+    ThreadBuffer* buffer;
+    TraceEvent* event = reserve(buffer);
+    if (event == nullptr) {
+        return;
+    }
+    event->startNs = startNs;
+    event->durationNs = endNs - startNs;
+    event->name = name;
+    event->category = category;
+    // Single writer: publish the filled slot to writeChromeTrace()
+    buffer->size.store(buffer->size.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void TraceRecorder::instant(const char* category, const char* text) {
+    ThreadBuffer* buffer;
+    TraceEvent* event = reserve(buffer);
+    if (event == nullptr) {
+        return;
+    }
+    event->startNs = nowNs();
+    event->durationNs = -1;
+    event->name = nullptr;
+    event->category = category;
+    std::strncpy(event->text, text, TraceEvent::TEXT_SIZE - 1);
+    event->text[TraceEvent::TEXT_SIZE - 1] = '\0';
+    buffer->size.store(buffer->size.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void TraceRecorder::enterState(const char* state) {
+    const std::int64_t now = nowNs();
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (currentState != nullptr) {
+        if (stateSpans.size() < capacity) {
+            TraceEvent event = {};
+            event.startNs = currentStateSinceNs;
+            event.durationNs = now - currentStateSinceNs;
+            event.name = currentState;
+            event.category = "state";
+            stateSpans.push_back(event);
+        } else {
+            unbuffered.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    currentState = state;
+    currentStateSinceNs = now;
+}
+
+long TraceRecorder::writeChromeTrace(const std::string& path, const std::string& processName) const {
+    std::string out;
+    long written = 0;
+    out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":";
+    appendJsonString(out, processName.c_str());
+    out += "}},\n";
+
+    appendThreadName(out, STATE_TRACK_TID, "machine state");
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        for (const TraceEvent& event : stateSpans) {
+            appendEvent(out, event, STATE_TRACK_TID);
+            written++;
+        }
+        if (currentState != nullptr) {
+            // The current state is still open: show it up to now
+            TraceEvent event = {};
+            event.startNs = currentStateSinceNs;
+            event.durationNs = nowNs() - currentStateSinceNs;
+            event.name = currentState;
+            event.category = "state";
+            appendEvent(out, event, STATE_TRACK_TID);
+            written++;
+        }
+    }
+
+    for (std::size_t i = 0; i < MAX_THREADS; i++) {
+        const ThreadBuffer* buffer = buffers[i].load(std::memory_order_acquire);
+        if (buffer == nullptr) {
+            continue;
+        }
+        const int tid = static_cast<int>(i) + 1;
+        char fallback[32];
+        std::snprintf(fallback, sizeof(fallback), "thread %d", tid);
+        appendThreadName(out, tid, buffer->threadName.empty() ? fallback : buffer->threadName.c_str());
+        const std::size_t size = buffer->size.load(std::memory_order_acquire);
+        for (std::size_t e = 0; e < size; e++) {
+            appendEvent(out, buffer->events[e], tid);
+            written++;
+        }
+    }
+    // JSON does not allow a trailing comma after the last event
+    out.resize(out.size() - 2);
+    out += "\n]}\n";
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    file.close();
+    return file ? written : -1;
+}
+
+std::uint64_t TraceRecorder::dropped() const {
+    std::uint64_t total = unbuffered.load(std::memory_order_relaxed);
+    for (const std::atomic<ThreadBuffer*>& slot : buffers) {
+        const ThreadBuffer* buffer = slot.load(std::memory_order_acquire);
+        if (buffer != nullptr) {
+            total += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+void TraceEventSink::consume(const StatusEvent& event) {
+    char message[256];
+    if (formatEvent(event, message, sizeof(message)) == 0) {
+        return;
+    }
+    // Drop the "[SEVERITY] " tag; the severity becomes the category
+    const char* text = message;
+    if (text[0] == '[') {
+        const char* end = std::strstr(text, "] ");
+        text = end != nullptr ? end + 2 : text;
+    }
+    recorder.instant(severityCategory(event.severity), text);
+}
@@ -1,4 +1,9 @@
 #include "labelmachine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 /**
  * @class LabelingMachine
  * @brief Main controller class for the ESPERA LM-3000 labeling machine
@@ -20,17 +25,82 @@
  * @endcode
  */
 LabelingMachine::LabelingMachine()
+    : LabelingMachine(MachineOptions())
+{
+}
+
+/**
+ * @brief Constructs a machine with the given id, log and console settings
+ * @param options Construction-time settings
+ */
+LabelingMachine::LabelingMachine(const MachineOptions& options)
     : state(MachineState::IDLE)
     , previousState(MachineState::IDLE)
     , sensors({false, 0, 0, 22.0})
+    , rampEngine(options.rampEngine != nullptr ? options.rampEngine : &RampEngine::shared())
     , productsLabeled(0)
     , errorCount(0)
-    , machineId("LM3000-001")
+    , clock(options.clock != nullptr ? options.clock : &SystemClock::instance())
+    , oee(options.shiftLength)
+    , machineId(options.machineId)
     , firmwareVersion("v2.1.0")
 {
-    std::cout << "[SYSTEM] Machine initialized: " << machineId
-              << " (Firmware: " << firmwareVersion << ")\n";
-    openLog();
+    publishConfig(MachineConfig());
+    if (options.traceEvents > 0) {
+        trace.reset(new TraceRecorder(options.traceEvents));
+        trace->enterState(machineStateName(state));
+        events.addSink(std::make_shared<TraceEventSink>(*trace), EventSeverity::DEBUG);
+    }
+    if (options.consoleSeverity != EventSeverity::OFF) {
+        events.addSink(std::make_shared<ConsoleEventSink>(), options.consoleSeverity);
+    }
+    stats.reset(clock->nowNs(), state);
+    oee.reset(clock->nowNs(), state);
+    updateIdealRate();
+    emitEvent(EventCode::MACHINE_INITIALIZED, 0, 0, 0, 0.0, firmwareVersion.c_str());
+    if (options.latencyStats || options.metricsPort >= 0) {
+        latency.reset(new LatencyRecorder());
+    }
+    openLog(options.log);
+    if (!options.checkpointPath.empty()) {
+        checkpoint.reset(new CounterCheckpoint(options.checkpointPath));
+        CheckpointCounters saved;
+        if (!checkpoint->isOpen()) {
+            checkpoint.reset();
+            emitEvent(EventCode::CHECKPOINT_FAILED, 0, 0, 0, 0.0, options.checkpointPath.c_str());
+        } else if (checkpoint->restore(saved)) {
+            productsLabeled = saved.productsLabeled;
+            errorCount = saved.errorCount;
+            setRoll(saved.labelRollRemaining);
+            countersRestored = true;
+            emitEvent(EventCode::COUNTERS_RESTORED, productsLabeled, errorCount, sensors.labelRollRemaining, 0.0,
+                      options.checkpointPath.c_str());
+        }
+    }
+    if (options.statusBlock) {
+        const std::string name = statusBlockName(machineId);
+        statusPublisher.reset(new StatusPublisher(name));
+        if (statusPublisher->isOpen()) {
+            emitEvent(EventCode::STATUS_BLOCK_OPENED, 0, 0, 0, 0.0, name.c_str());
+            publishStatus();
+        } else {
+            statusPublisher.reset();
+            emitEvent(EventCode::STATUS_BLOCK_FAILED, 0, 0, 0, 0.0, name.c_str());
+        }
+    }
+    if (options.metricsPort >= 0) {
+        metrics.reset(new MachineMetrics());
+        publishStatus();
+        metricsServer.reset(new MetricsServer(static_cast<std::uint16_t>(options.metricsPort),
+            [this](std::string& body) { appendMetricsText(body, machineId, *metrics, latency.get()); }));
+        if (metricsServer->isRunning()) {
+            emitEvent(EventCode::METRICS_SERVING, metricsServer->port());
+        } else {
+            metricsServer.reset();
+            metrics.reset();
+            emitEvent(EventCode::METRICS_FAILED, options.metricsPort);
+        }
+    }
 }
  
 
@@ -38,11 +108,89 @@ LabelingMachine::LabelingMachine()
 * @brief Destructor - ensures machine is safely stopped
  */
 LabelingMachine::~LabelingMachine() {
+    // The watcher thread calls into the machine: stop it first
+    unwatchConfig();
+    if (eventsDeferred.load(std::memory_order_acquire)) {
+        emitDeferredEvents();
+    }
+    if (ramp) {
+        ramp->cancel();
+    }
     if (state == MachineState::RUNNING) {
         stop();
     }
     closeLog();
-    std::cout << "[SYSTEM] Machine shutdown complete\n";
+    if (checkpoint) {
+        checkpoint->sync();
+    }
+    emitEvent(EventCode::MACHINE_SHUTDOWN);
+}
+
+const LabelingMachine::StateHooks LabelingMachine::STATE_HOOKS[MACHINE_STATE_COUNT] = {
+    /* IDLE */        {&LabelingMachine::onEnterIdle, nullptr},
+    /* RUNNING */     {nullptr, nullptr},
+    /* LOW_LABEL */   {nullptr, nullptr},
+    /* PAUSED */      {&LabelingMachine::onEnterPaused, nullptr},
+    /* ERROR */       {nullptr, nullptr},
+    /* MAINTENANCE */ {&LabelingMachine::onEnterMaintenance, nullptr},
+};
+
+/**
+ * @brief Entering IDLE halts the conveyor
+ */
+void LabelingMachine::onEnterIdle() {
+    sensors.conveyorSpeed = 0;
+}
+
+/**
+ * @brief Entering PAUSED remembers the sensor state for resume() and halts the conveyor
+ */
+void LabelingMachine::onEnterPaused() {
+    previousSensors = sensors;
+    sensors.conveyorSpeed = 0;
+}
+
+/**
+ * @brief Entering MAINTENANCE runs the conveyor at the fixed maintenance speed
+ */
+void LabelingMachine::onEnterMaintenance() {
+    sensors.conveyorSpeed = currentConfig().maintenanceSpeed;
+}
+
+/**
+ * @brief Applies a state event through STATE_TRANSITIONS
+ * @return false if the event is not legal in the current state
+ */
+bool LabelingMachine::transition(StateEvent event) {
+    OperationTimer timer(latency.get(), MetricOperation::TRANSITION);
+    const StateTransition next = lookupTransition(state, event);
+    if (!next.legal) {
+        return false;
+    }
+    if (next.target == state) {
+        return true;
+    }
+    if (ramp && !isTransitionLegal(next.target, StateEvent::SET_SPEED)) {
+        cancelRamp();
+    }
+    const StateHooks& leaving = STATE_HOOKS[static_cast<std::size_t>(state)];
+    if (leaving.onExit != nullptr) {
+        (this->*leaving.onExit)();
+    }
+    const std::int64_t nowNs = clock->nowNs();
+    stats.onTransition(state, next.target, nowNs);
+    oee.onTransition(next.target, nowNs);
+    previousState = state;
+    state = next.target;
+    if (trace) {
+        trace->enterState(machineStateName(state));
+    }
+    const StateHooks& entering = STATE_HOOKS[static_cast<std::size_t>(state)];
+    if (entering.onEnter != nullptr) {
+        (this->*entering.onEnter)();
+    }
+    publishStatus();
+    return true;
 }
 
 /**
@@ -59,33 +207,34 @@ LabelingMachine::~LabelingMachine() {
  * - Label supply must be available
  */
 bool LabelingMachine::start() {
-    if (state != MachineState::IDLE) {
-        std::cout << "[WARNING] Cannot start machine - not in IDLE state\n";
+    OperationTimer timer(latency.get(), MetricOperation::START);
+    TraceSpan span(trace.get(), "start");
+    if (!isTransitionLegal(state, StateEvent::START)) {
+        emitEvent(EventCode::START_REJECTED);
         return false;
     }
 
     if (!isTemperatureSafe()) {
-        std::cout << "[ERROR] Cannot start - temperature too high: "
-                  << sensors.temperature << "°C\n";
-        state = MachineState::ERROR;
+        transition(StateEvent::FAULT);
+        emitEvent(EventCode::START_OVER_TEMPERATURE, 0, 0, 0, sensors.temperature);
         return false;
     }
 
     if (sensors.labelRollRemaining == 0) {
-        std::cout << "[ERROR] Cannot start - no labels available\n";
-        state = MachineState::ERROR;
+        transition(StateEvent::FAULT);
+        emitEvent(EventCode::START_NO_LABELS);
         return false;
     }
 
-    state = MachineState::RUNNING;
-    previousState = MachineState::RUNNING;
+    transition(StateEvent::START);
     if (isLowerLabels()) {
-        std::cout << "[WARNING] Low label warning - Labels remaining: "
-                  << sensors.labelRollRemaining << "\n";
-        state = MachineState::LOW_LABEL;
+        transition(StateEvent::LABELS_LOW);
+        emitEvent(EventCode::LOW_LABEL_WARNING, sensors.labelRollRemaining);
     }
-    sensors.conveyorSpeed = config.defaultSpeed;
-    std::cout << "[INFO] Machine started - Speed: " << config.defaultSpeed << " mm/s\n";
+    const int speed = currentConfig().defaultSpeed;
+    sensors.conveyorSpeed = speed;
+    publishStatus();
+    emitEvent(EventCode::STARTED, speed);
     return true;
 }
 
@@ -96,11 +245,9 @@ bool LabelingMachine::start() {
  * Can be called from any state (acts as emergency stop).
  */
 void LabelingMachine::stop() {
-    previousState = state;
-    state = MachineState::IDLE;
-    sensors.conveyorSpeed = 0;
-    std::cout << "[INFO] Machine stopped - Total labeled: "
-              << productsLabeled << "\n";
+    OperationTimer timer(latency.get(), MetricOperation::STOP);
+    transition(StateEvent::STOP);
+    emitEvent(EventCode::STOPPED, productsLabeled);
 }
 
 /**
@@ -120,37 +267,61 @@ void LabelingMachine::stop() {
  *       and wait for label application confirmation
  */
 void LabelingMachine::applyLabel() {
-    if (state != MachineState::RUNNING && state != MachineState::LOW_LABEL) {
+    OperationTimer timer(latency.get(), MetricOperation::LABEL);
+    TraceSpan span(trace.get(), "applyLabel");
+    if (!isTransitionLegal(state, StateEvent::LABEL)) {
         return;
     }
     if (!sensors.productDetected) {
         return;
     }
+    if (ramp) {
+        adoptRampSpeed();
+    }
 
     if (sensors.labelRollRemaining > 0) {
         sensors.labelRollRemaining--;
         productsLabeled++;
+        const std::int64_t nowNs = clock->nowNs();
+        stats.onLabel(true);
+        oee.onLabel(true, nowNs);
+        rollForecast.onLabel(nowNs);
+        if (!rollChangeWarned) {
+            checkRollForecast();
+        }
         if (isLowerLabels()) {
-            std::cout << "[WARNING] Low label warning - Labels remaining: "
-                      << sensors.labelRollRemaining << "\n";
-            state = MachineState::LOW_LABEL;
-        } 
+            transition(StateEvent::LABELS_LOW);
+            emitEvent(EventCode::LOW_LABEL_WARNING, sensors.labelRollRemaining);
+        }
         // Log production event
-        logEntry("SUCCESS");
+        logEntry(LogStatus::SUCCESS);
         // Simulate temperature increase from operation
         sensors.temperature += 0.1;
 
-        std::cout << "[PRODUCTION] Label applied - Product #"
-                  << productsLabeled
-                  << " | Labels remaining: " << sensors.labelRollRemaining
-                  << "\n";
+        emitEvent(EventCode::LABEL_APPLIED, productsLabeled, sensors.labelRollRemaining);
+        switch (batches.onLabel(sensors.labelRollRemaining)) {
+            case BatchStep::STAGE_ROLL:
+                emitEvent(EventCode::ROLL_CHANGE_STAGED, batches.next()->rollLabels, batches.current().remaining(), 0,
+                          0.0, batches.next()->batchId.c_str());
+                break;
+            case BatchStep::COMPLETE:
+                emitEvent(EventCode::BATCH_COMPLETED, batches.current().labeled, 0, 0, 0.0,
+                          batches.current().batchId.c_str());
+                advanceBatch();
+                break;
+            case BatchStep::NONE:
+                break;
+        }
     } else {
-        state = MachineState::ERROR;
+        transition(StateEvent::FAULT);
         errorCount++;
-        logEntry("FAILURE");
+        stats.onLabel(false);
+        oee.onLabel(false, clock->nowNs());
+        logEntry(LogStatus::FAILURE);
         sensors.conveyorSpeed = 0;
-        std::cout << "[ERROR] Label application failed - Roll empty!\n";
+        emitEvent(EventCode::LABEL_FAILED);
     }
+    publishStatus();
 }
 
 /**
@@ -163,13 +334,25 @@ void LabelingMachine::applyLabel() {
  * machine is running, label application is automatically triggered.
  */
 void LabelingMachine::detectProduct(bool detected) {
+    OperationTimer timer(latency.get(), MetricOperation::DETECT_PRODUCT);
     sensors.productDetected = detected;
-    if (detected && (state == MachineState::RUNNING || state == MachineState::LOW_LABEL)) {
-        std::cout << "[SENSOR] Product detected at labeling position\n";
-        applyLabel();
+    if (detected && isTransitionLegal(state, StateEvent::LABEL)) {
+        emitEvent(EventCode::PRODUCT_DETECTED);
+        applyLabel();   // Publishes the status
+    } else {
+        publishStatus();
     }
 }
 
+/**
+ * @brief Records a reading of the temperature monitoring system
+ * @param celsius Measured system temperature in °C
+ */
+void LabelingMachine::updateTemperature(double celsius) {
+    sensors.temperature = celsius;
+    publishStatus();
+}
+
 /**
  * @brief Displays comprehensive machine status
  *
@@ -184,16 +367,10 @@ void LabelingMachine::printStatus() const {
     std::cout << "║ Machine ID: " << std::left << std::setw(30) << machineId << "   ║\n";
     std::cout << "║ State:      " << std::left << std::setw(30);
 
-    switch(state) {
-        case MachineState::IDLE:        std::cout << "IDLE"; break;
-        case MachineState::RUNNING:     std::cout << "RUNNING"; break;
-        case MachineState::LOW_LABEL:   std::cout << "LOW_LABEL"; 
-            std::cout << "   ║\n";
-            std::cout << "║ [WARNING] Low label warning               ";
-            break;
-        case MachineState::PAUSED:      std::cout << "PAUSED"; break;
-        case MachineState::ERROR:       std::cout << "ERROR"; break;
-        case MachineState::MAINTENANCE: std::cout << "MAINTENANCE"; break;
+    std::cout << machineStateName(state);
+    if (state == MachineState::LOW_LABEL) {
+        std::cout << "   ║\n";
+        std::cout << "║ [WARNING] Low label warning               ";
     }
     std::cout << "   ║\n";
     std::cout << "╠══════════════════════════════════════════════╣\n";
@@ -217,23 +394,81 @@ void LabelingMachine::printStatus() const {
  * Requested speed must be within MIN_SPEED and MAX_SPEED limits.
  */
 bool LabelingMachine::setSpeed(int speed) {
-    if (state != MachineState::RUNNING && state != MachineState::LOW_LABEL) {
-        std::cout << "[WARNING] Cannot adjust speed - machine not running\n";
+    OperationTimer timer(latency.get(), MetricOperation::SET_SPEED);
+    if (!isTransitionLegal(state, StateEvent::SET_SPEED)) {
+        emitEvent(EventCode::SPEED_REJECTED);
         return false;
     }
 
     if (!isSpeedValid(speed)) {
-        std::cout << "[ERROR] Invalid speed: " << speed
-                  << " mm/s (valid range: " << config.minSpeed
-                  << "-" << config.maxSpeed << ")\n";
+        const MachineConfig& limits = currentConfig();
+        emitEvent(EventCode::SPEED_INVALID, speed, limits.minSpeed, limits.maxSpeed);
         return false;
     }
 
+    if (ramp) {
+        cancelRamp();
+    }
     sensors.conveyorSpeed = speed;
-    std::cout << "[INFO] Speed changed to " << speed << " mm/s\n";
+    publishStatus();
+    emitEvent(EventCode::SPEED_CHANGED, speed);
+    return true;
+}
+
+/**
+ * @brief Starts a ramp from the current speed to the requested one
+ *
+ * Validated like setSpeed(); the ramp engine advances it from the next tick.
+ * The ramp runs on the machine's clock.
+ */
+bool LabelingMachine::rampSpeed(int speed, RampProfile profile) {
+    OperationTimer timer(latency.get(), MetricOperation::SET_SPEED);
+    if (!isTransitionLegal(state, StateEvent::SET_SPEED)) {
+        emitEvent(EventCode::SPEED_REJECTED);
+        return false;
+    }
+
+    const MachineConfig& settings = currentConfig();
+    if (!isSpeedValid(speed)) {
+        emitEvent(EventCode::SPEED_INVALID, speed, settings.minSpeed, settings.maxSpeed);
+        return false;
+    }
+
+    if (ramp) {
+        cancelRamp();
+    }
+    RampPlan plan;
+    plan.fromSpeed = sensors.conveyorSpeed;
+    plan.toSpeed = speed;
+    plan.profile = profile;
+    plan.acceleration = settings.rampAcceleration;
+    plan.jerk = settings.rampJerk;
+    ramp = rampEngine->start(plan, nullptr, clock);
+    emitEvent(EventCode::SPEED_RAMP_STARTED, plan.fromSpeed, speed, static_cast<int>(profile), plan.duration());
     return true;
 }
 
+void LabelingMachine::adoptRampSpeed() {
+    // Computed for now rather than taken from the engine's last tick, so the
+    // speed matches the machine's time even when a simulated clock jumps ahead
+    const double seconds = ramp->elapsedSeconds();
+    const bool done = seconds >= ramp->duration();
+    sensors.conveyorSpeed = clampSpeed(ramp->plan().speedAt(seconds));
+    if (done) {
+        ramp.reset();
+        emitEvent(EventCode::SPEED_RAMP_COMPLETE, sensors.conveyorSpeed);
+    }
+}
+
+void LabelingMachine::cancelRamp() {
+    ramp->cancel();
+    adoptRampSpeed();
+    if (ramp) {
+        emitEvent(EventCode::SPEED_RAMP_CANCELLED, sensors.conveyorSpeed, ramp->plan().toSpeed);
+        ramp.reset();
+    }
+}
+
 /**
  * @brief Gets current machine state
  * @return Current MachineState
@@ -250,6 +485,30 @@ int LabelingMachine::getProductionCount() const {
     return productsLabeled;
 }
 
+/**
+ * @brief Gets the production statistics of the current session
+ * @return Snapshot as of the machine clock's current time
+ */
+ProductionStatistics LabelingMachine::getStatistics() const {
+    return stats.snapshot(clock->nowNs());
+}
+
+/**
+ * @brief Gets the Overall Equipment Effectiveness
+ * @return OEE per window as of the machine clock's current time
+ */
+OeeReport LabelingMachine::getOee() const {
+    return oee.report(clock->nowNs());
+}
+
+/**
+ * @brief Gets the machine identifier
+ * @return Unique machine id
+ */
+const std::string& LabelingMachine::getMachineId() const {
+    return machineId;
+}
+
 /**
  * @brief Resets production counters
  *
@@ -260,9 +519,11 @@ void LabelingMachine::resetCounters() {
     if (state == MachineState::IDLE) {
         productsLabeled = 0;
         errorCount = 0;
-        std::cout << "[INFO] Production counters reset\n";
+        stats.reset(clock->nowNs(), state);
+        publishStatus();
+        emitEvent(EventCode::COUNTERS_RESET);
     } else {
-        std::cout << "[WARNING] Cannot reset counters while machine is operating\n";
+        emitEvent(EventCode::COUNTERS_RESET_REJECTED);
     }
 }
 
@@ -271,22 +532,117 @@ void LabelingMachine::resetCounters() {
  * @param labelCount Number of labels in the new roll
  */
 void LabelingMachine::loadLabelRoll(int labelCount) {
+    OperationTimer timer(latency.get(), MetricOperation::LOAD_ROLL);
     if (labelCount < 0) {
-        std::cout << "[ERROR] Invalid label count\n";
+        emitEvent(EventCode::ROLL_INVALID);
         return;
     }
 
-    sensors.labelRollRemaining = labelCount;
-    std::cout << "[INFO] Label roll loaded: " << labelCount << " labels\n";
+    setRoll(labelCount);
+    publishStatus();
+    emitEvent(EventCode::ROLL_LOADED, labelCount);
     // Clear error state if it was due to empty labels
-    if (state == MachineState::LOW_LABEL && labelCount >= config.lowLabelThreshold) {
-        state = MachineState::RUNNING;
-        std::cout << "[INFO] Low Label Warning cleared - machine is running\n";
+    if (labelCount >= currentConfig().lowLabelThreshold && transition(StateEvent::LABELS_RESTORED)) {
+        emitEvent(EventCode::LOW_LABEL_CLEARED);
     }
 
     // Clear error state if it was due to empty labels
-    if (state == MachineState::ERROR && labelCount > 0) {
-        state = MachineState::IDLE;
-        std::cout << "[INFO] Error cleared - machine ready\n";
+    if (labelCount > 0 && transition(StateEvent::CLEAR_FAULT)) {
+        emitEvent(EventCode::ERROR_CLEARED);
     }
 }
+
+/**
+ * @brief Builds an event from the current machine state and dispatches it
+ */
+void LabelingMachine::dispatchEvent(EventCode code, int value1, int value2, int value3,
+                                    double measurement, const char* detail) {
+    StatusEvent event;
+    event.timestampNs = clock->nowNs();
+    event.code = code;
+    event.severity = eventSeverity(code);
+    event.state = state;
+    event.value1 = value1;
+    event.value2 = value2;
+    event.value3 = value3;
+    event.measurement = measurement;
+    event.machineId = machineId.c_str();
+    event.detail = detail;
+    events.dispatch(event);
+}
+
+/**
+ * @brief Copies state, sensors and counters into the status block
+ */
+void LabelingMachine::writeStatus() {
+    MachineStatusSnapshot snapshot = {};
+    snapshot.updatedNs = clock->nowNs();
+    snapshot.configVersion = configVersion.load(std::memory_order_relaxed);
+    snapshot.state = static_cast<std::uint8_t>(state);
+    snapshot.previousState = static_cast<std::uint8_t>(previousState);
+    snapshot.productDetected = sensors.productDetected ? 1 : 0;
+    snapshot.conveyorSpeed = sensors.conveyorSpeed;
+    snapshot.labelRollRemaining = sensors.labelRollRemaining;
+    snapshot.productsLabeled = productsLabeled;
+    snapshot.errorCount = errorCount;
+    snapshot.temperature = sensors.temperature;
+    std::strncpy(snapshot.machineId, machineId.c_str(), sizeof(snapshot.machineId) - 1);
+    statusPublisher->publish(snapshot);
+}
+
+/**
+ * @brief Copies state, sensors and counters into the metric gauges
+ */
+void LabelingMachine::updateMetrics() {
+    metrics->productsLabeled.store(productsLabeled, std::memory_order_relaxed);
+    metrics->errorCount.store(errorCount, std::memory_order_relaxed);
+    metrics->labelRollRemaining.store(sensors.labelRollRemaining, std::memory_order_relaxed);
+    metrics->temperature.store(sensors.temperature, std::memory_order_relaxed);
+    metrics->conveyorSpeed.store(sensors.conveyorSpeed, std::memory_order_relaxed);
+    metrics->state.store(static_cast<std::uint8_t>(state), std::memory_order_relaxed);
+}
+
+bool LabelingMachine::writeTrace(const std::string& path) {
+    if (!trace) {
+        emitEvent(EventCode::TRACE_WRITE_FAILED, 0, 0, 0, 0.0, "(tracing is off)");
+        return false;
+    }
+    const long written = trace->writeChromeTrace(path, machineId);
+    if (written < 0) {
+        emitEvent(EventCode::TRACE_WRITE_FAILED, 0, 0, 0, 0.0, path.c_str());
+        return false;
+    }
+    const std::uint64_t dropped = trace->dropped();
+    emitEvent(EventCode::TRACE_WRITTEN, static_cast<int>(written),
+              static_cast<int>(std::min<std::uint64_t>(dropped, std::numeric_limits<int>::max())), 0, 0.0, path.c_str());
+    return true;
+}
+
+/**
+ * @brief Replaces the machine's time source
+ * @param newClock Clock to use (null restores the system clock)
+ */
+void LabelingMachine::setClock(const MachineClock* newClock) {
+    if (ramp) {
+        cancelRamp();   // Runs on the old clock
+    }
+    clock = newClock != nullptr ? newClock : &SystemClock::instance();
+    stats.reset(clock->nowNs(), state);
+    oee.reset(clock->nowNs(), state);
+}
+
+/**
+ * @brief Attaches an event sink
+ * @param sink Sink to receive machine events
+ * @param minSeverity Lowest severity delivered to this sink
+ */
+void LabelingMachine::addEventSink(std::shared_ptr<EventSink> sink, EventSeverity minSeverity) {
+    events.addSink(std::move(sink), minSeverity);
+}
+
+/**
+ * @brief Detaches all event sinks
+ */
+void LabelingMachine::clearEventSinks() {
+    events.clear();
+}
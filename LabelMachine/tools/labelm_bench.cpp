@@ -0,0 +1,347 @@
+/**
+ * @file labelm_bench.cpp
+ * @brief Hot-path benchmark for a single LabelingMachine, JSON output
+ *
+ * Usage: labelm_bench [--iterations N] [--logging on|off] [--format csv|journal|ring]
+ *                     [--console on|off] [--rolls N[,N...]] [--output file.json]
+ *
+ * For every roll size the benchmark times, call by call:
+ *   - label_cycle     detectProduct(true) including applyLabel()
+ *   - log_entry       logEntry(LogStatus::SUCCESS)
+ *   - current_time    getCurrentTime() (std::string) and the buffer overload
+ *   - print_status    printStatus()
+ *   - load_config     loadConfig() of a generated configuration file
+ * and, separately, the sensor ingestion path (labelm_sensors.h): a producer
+ * thread pushes bursts of product edges while the control thread drains
+ * them, reporting capture-to-label latency. It reports throughput plus latency percentiles as JSON (stdout unless
+ * --output is given) so results can be compared release to release.
+ *
+ * Console output (events and printStatus) is written into a discarding
+ * stream buffer: "--console on" measures event formatting and stream cost,
+ * not the speed of the terminal.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "labelmachine.h"
+#include "labelm_sensors.h"
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+/// Stream buffer that accepts and discards everything
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+struct BenchOptions {
+    std::size_t iterations = 100000;
+    bool logging = true;
+    LogFormat format = LogFormat::CSV;
+    bool console = false;
+    std::vector<int> rollSizes = {1000, 100000};
+    std::string output;
+};
+
+struct OperationResult {
+    std::string name;
+    std::size_t calls = 0;
+    double totalSeconds = 0.0;
+    double meanNs = 0.0;
+    std::int64_t p50Ns = 0;
+    std::int64_t p90Ns = 0;
+    std::int64_t p99Ns = 0;
+    std::int64_t p999Ns = 0;
+    std::int64_t maxNs = 0;
+};
+
+struct RunResult {
+    int rollSize = 0;
+    std::vector<OperationResult> operations;
+    LogWriterStats logStats;
+    SensorIngestionStats ingestion;
+};
+
+/**
+ * @brief Times `calls` invocations of op individually; setup runs untimed before each call
+ */
+template <typename Setup, typename Op>
+OperationResult measure(const std::string& name, std::size_t calls, Setup setup, Op op) {
+    std::vector<std::int64_t> samples;
+    samples.reserve(calls);
+    for (std::size_t i = 0; i < calls; i++) {
+        setup();
+        const BenchClock::time_point begin = BenchClock::now();
+        op();
+        const BenchClock::time_point end = BenchClock::now();
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+    }
+
+    OperationResult result;
+    result.name = name;
+    result.calls = calls;
+    if (samples.empty()) {
+        return result;
+    }
+    double total = 0.0;
+    for (std::int64_t sample : samples) {
+        total += static_cast<double>(sample);
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double p) {
+        std::size_t index = static_cast<std::size_t>(p * (samples.size() - 1));
+        return samples[index];
+    };
+    result.totalSeconds = total / 1e9;
+    result.meanNs = total / samples.size();
+    result.p50Ns = percentile(0.50);
+    result.p90Ns = percentile(0.90);
+    result.p99Ns = percentile(0.99);
+    result.p999Ns = percentile(0.999);
+    result.maxNs = samples.back();
+    return result;
+}
+
+/**
+ * @brief Pushes `products` detect/clear pairs from a producer thread through SensorIngestion
+ */
+SensorIngestionStats runIngestion(const MachineOptions& machineOptions, std::size_t products) {
+    LabelingMachine machine(machineOptions);
+    machine.loadLabelRoll(static_cast<int>(products) + 1);
+    machine.start();
+
+    SensorIngestion ingestion(machine);
+    ingestion.start();
+    std::thread producer([&]() {
+        SensorProducer& sensor = ingestion.producer(0);
+        for (std::size_t i = 0; i < products; i++) {
+            // A full ring is counted as a drop; retry like a sensor that stays blocked
+            while (!sensor.productDetected(true)) {
+                std::this_thread::yield();
+            }
+            while (!sensor.productDetected(false)) {
+                std::this_thread::yield();
+            }
+            if (i % 32 == 31) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    });
+    producer.join();
+    ingestion.stop();
+    machine.stop();
+    return ingestion.stats();
+}
+
+RunResult runBenchmark(const BenchOptions& options, int rollSize, const std::string& configPath) {
+    MachineOptions machineOptions;
+    machineOptions.machineId = "LM3000-BENCH";
+    machineOptions.consoleSeverity = options.console ? EventSeverity::DEBUG : EventSeverity::OFF;
+    machineOptions.log.format = options.logging ? options.format : LogFormat::DISABLED;
+    machineOptions.log.path = options.logging ? "labelm_bench_log.tmp" : "";
+
+    RunResult run;
+    run.rollSize = rollSize;
+    LabelingMachine machine(machineOptions);
+    machine.loadConfig(configPath);
+    machine.loadLabelRoll(rollSize);
+    machine.start();
+
+    const std::size_t n = options.iterations;
+    // Reload the roll (untimed) before it runs out so every call labels a product
+    int remaining = rollSize;
+    auto keepRollLoaded = [&]() {
+        machine.detectProduct(false);
+        if (remaining == 0) {
+            machine.loadLabelRoll(rollSize);
+            remaining = rollSize;
+        }
+        remaining--;
+    };
+    run.operations.push_back(measure("label_cycle", n, keepRollLoaded,
+                                     [&]() { machine.detectProduct(true); }));
+    run.operations.push_back(measure("log_entry", n, []() {},
+                                     [&]() { machine.logEntry(LogStatus::SUCCESS); }));
+    run.operations.push_back(measure("current_time_string", n, []() {},
+                                     [&]() { volatile std::size_t length = machine.getCurrentTime().size(); (void)length; }));
+    run.operations.push_back(measure("current_time_buffer", n, []() {}, [&]() {
+        char buffer[TimestampFormatter::BUFFER_SIZE];
+        volatile std::size_t length = machine.getCurrentTime(buffer, sizeof(buffer));
+        (void)length;
+    }));
+    run.operations.push_back(measure("print_status", std::max<std::size_t>(1, n / 100), []() {},
+                                     [&]() { machine.printStatus(); }));
+    run.operations.push_back(measure("load_config", std::max<std::size_t>(1, n / 1000), []() {},
+                                     [&]() { machine.loadConfig(configPath); }));
+
+    machine.stop();
+    run.logStats = machine.getLogStats();
+    run.ingestion = runIngestion(machineOptions, n);
+    return run;
+}
+
+std::vector<int> parseRollSizes(const char* text) {
+    std::vector<int> sizes;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int value = std::atoi(item.c_str());
+        if (value > 0) {
+            sizes.push_back(value);
+        }
+    }
+    return sizes;
+}
+
+bool parseArgs(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* key = argv[i];
+        const char* value = argv[i + 1];
+        if (std::strcmp(key, "--iterations") == 0) {
+            options.iterations = static_cast<std::size_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(key, "--logging") == 0) {
+            options.logging = std::strcmp(value, "off") != 0;
+        } else if (std::strcmp(key, "--console") == 0) {
+            options.console = std::strcmp(value, "on") == 0;
+        } else if (std::strcmp(key, "--format") == 0) {
+            if (std::strcmp(value, "csv") == 0) options.format = LogFormat::CSV;
+            else if (std::strcmp(value, "journal") == 0) options.format = LogFormat::BINARY_JOURNAL;
+            else if (std::strcmp(value, "ring") == 0) options.format = LogFormat::MAPPED_RING;
+            else return false;
+        } else if (std::strcmp(key, "--rolls") == 0) {
+            options.rollSizes = parseRollSizes(value);
+        } else if (std::strcmp(key, "--output") == 0) {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.iterations > 0 && !options.rollSizes.empty();
+}
+
+const char* formatName(LogFormat format) {
+    switch (format) {
+        case LogFormat::CSV:            return "csv";
+        case LogFormat::BINARY_JOURNAL: return "journal";
+        case LogFormat::MAPPED_RING:    return "ring";
+        case LogFormat::DISABLED:       return "disabled";
+    }
+    return "unknown";
+}
+
+void writeJson(std::ostream& out, const BenchOptions& options, const std::vector<RunResult>& runs) {
+    char line[512];
+    out << "{\n";
+    out << "  \"benchmark\": \"labelm_bench\",\n";
+    out << "  \"config\": {\n";
+    std::snprintf(line, sizeof(line),
+                  "    \"iterations\": %zu,\n    \"logging\": %s,\n    \"format\": \"%s\",\n    \"console\": %s\n",
+                  options.iterations, options.logging ? "true" : "false",
+                  options.logging ? formatName(options.format) : "disabled",
+                  options.console ? "true" : "false");
+    out << line << "  },\n";
+    out << "  \"runs\": [\n";
+    for (std::size_t r = 0; r < runs.size(); r++) {
+        const RunResult& run = runs[r];
+        out << "    {\n";
+        out << "      \"roll_size\": " << run.rollSize << ",\n";
+        std::snprintf(line, sizeof(line),
+                      "      \"log\": {\"queued\": %llu, \"written\": %llu, \"dropped\": %llu},\n",
+                      static_cast<unsigned long long>(run.logStats.queued),
+                      static_cast<unsigned long long>(run.logStats.written),
+                      static_cast<unsigned long long>(run.logStats.dropped));
+        out << line;
+        const SensorIngestionStats& in = run.ingestion;
+        std::snprintf(line, sizeof(line),
+                      "      \"sensor_ingestion\": {\"received\": %llu, \"dropped\": %llu, \"batches\": %llu, "
+                      "\"max_batch\": %llu, \"labeled\": %llu, \"latency_mean_ns\": %.1f, "
+                      "\"latency_p50_ns\": %llu, \"latency_p99_ns\": %llu, \"latency_max_ns\": %llu},\n",
+                      static_cast<unsigned long long>(in.received), static_cast<unsigned long long>(in.dropped),
+                      static_cast<unsigned long long>(in.batches), static_cast<unsigned long long>(in.maxBatch),
+                      static_cast<unsigned long long>(in.labeled), in.meanLatencyNs(),
+                      static_cast<unsigned long long>(in.latencyPercentileNs(0.50)),
+                      static_cast<unsigned long long>(in.latencyPercentileNs(0.99)),
+                      static_cast<unsigned long long>(in.latencyMaxNs));
+        out << line;
+        out << "      \"operations\": {\n";
+        for (std::size_t i = 0; i < run.operations.size(); i++) {
+            const OperationResult& op = run.operations[i];
+            const double opsPerSecond = op.totalSeconds > 0.0 ? op.calls / op.totalSeconds : 0.0;
+            std::snprintf(line, sizeof(line),
+                          "        \"%s\": {\"calls\": %zu, \"ops_per_sec\": %.1f, \"mean_ns\": %.1f, "
+                          "\"p50_ns\": %lld, \"p90_ns\": %lld, \"p99_ns\": %lld, \"p999_ns\": %lld, \"max_ns\": %lld}%s\n",
+                          op.name.c_str(), op.calls, opsPerSecond, op.meanNs,
+                          static_cast<long long>(op.p50Ns), static_cast<long long>(op.p90Ns),
+                          static_cast<long long>(op.p99Ns), static_cast<long long>(op.p999Ns),
+                          static_cast<long long>(op.maxNs), i + 1 < run.operations.size() ? "," : "");
+            out << line;
+        }
+        out << "      }\n";
+        out << "    }" << (r + 1 < runs.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--iterations N] [--logging on|off] [--format csv|journal|ring]"
+                  << " [--console on|off] [--rolls N[,N...]] [--output file.json]\n";
+        return 2;
+    }
+
+    // Representative configuration file for the load_config measurement
+    const std::string configPath = "labelm_bench_config.tmp";
+    {
+        std::ofstream config(configPath);
+        config << "# labelm_bench generated configuration\n"
+               << "defaultSpeed=150\nmaxSpeed=300\nminSpeed=50\nmaintenanceSpeed=20\n"
+               << "initialLabelCount=1000\nlowLabelThreshold=50\n"
+               << "nominalTemperature=22.5\nmaxTemperature=65.0\n";
+    }
+
+    // Keep machine chatter and status boxes out of the measurement output
+    NullBuffer nullBuffer;
+    std::streambuf* originalCout = std::cout.rdbuf(&nullBuffer);
+    std::streambuf* originalCerr = std::cerr.rdbuf(&nullBuffer);
+
+    std::vector<RunResult> runs;
+    for (int rollSize : options.rollSizes) {
+        runs.push_back(runBenchmark(options, rollSize, configPath));
+    }
+
+    std::cout.rdbuf(originalCout);
+    std::cerr.rdbuf(originalCerr);
+    std::remove(configPath.c_str());
+    std::remove("labelm_bench_log.tmp");
+
+    if (options.output.empty()) {
+        writeJson(std::cout, options, runs);
+    } else {
+        std::ofstream out(options.output);
+        if (!out) {
+            std::cerr << "[ERROR] Cannot create output file: " << options.output << "\n";
+            return 1;
+        }
+        writeJson(out, options, runs);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file labelm_export.cpp
+ * @brief Converts a binary production journal or ring log to the CSV production log
+ *
+ * Usage: labelm-export <journal|ring> [output.csv]
+ *
+ * The input format is detected from the file magic. For a memory-mapped
+ * ring log (also one left behind by a crashed controller) the retained
+ * records are exported oldest first.
+ *
+ * Output uses the same `Timestamp,ProductID,Temperature,Speed,Status`
+ * layout as the text log written by LabelingMachine::openLog(). Without
+ * an output file the CSV is written to stdout.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "labelm_journal.h"
+#include "labelm_ringlog.h"
+
+namespace {
+
+bool isRingLog(const char* path) {
+    char magic[4] = {};
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, RING_LOG_MAGIC, sizeof(magic)) == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <journal|ring> [output.csv]\n";
+        return 2;
+    }
+
+    std::FILE* out = stdout;
+    if (argc == 3) {
+        out = std::fopen(argv[2], "w");
+        if (out == nullptr) {
+            std::cerr << "[ERROR] Cannot create output file: " << argv[2] << "\n";
+            return 1;
+        }
+    }
+
+    // Large stdio buffer: rows are tiny and written back to back
+    static char outputBuffer[1 << 20];
+    std::setvbuf(out, outputBuffer, _IOFBF, sizeof(outputBuffer));
+    std::fputs(CSV_LOG_HEADER, out);
+
+    TimestampFormatter formatter;
+    unsigned long long rows = 0;
+    std::string error;
+    auto writeRow = [&](const LogRecord& record) {
+        char row[128];
+        std::size_t length = formatCsvRow(record, formatter, row, sizeof(row));
+        std::fwrite(row, 1, length, out);
+        rows++;
+    };
+    bool ok = isRingLog(argv[1]) ? readRingLog(argv[1], writeRow, error)
+                                 : readJournal(argv[1], writeRow, error);
+
+    if (std::fflush(out) != 0) {
+        std::cerr << "[ERROR] Write failed\n";
+        ok = false;
+    }
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    if (!ok) {
+        if (!error.empty()) {
+            std::cerr << "[ERROR] " << error << "\n";
+        }
+        return 1;
+    }
+    std::cerr << "[INFO] Exported " << rows << " records\n";
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file labelm_fleet_bench.cpp
+ * @brief Scaling benchmark for FleetController
+ *
+ * Usage: labelm_fleet_bench [--lines N] [--products P] [--workers W] [--producers K]
+ *
+ * Feeds P products (detect + clear) to each of N lines from K producer
+ * threads and reports aggregate throughput and per-line latency. Without
+ * --workers the run is repeated for 1, 2, 4, ... worker threads up to the
+ * number of hardware threads, which shows how throughput scales with cores.
+ * Machines log to memory-mapped rings and have no console output, so the
+ * benchmark measures the control path rather than terminal speed.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "labelm_fleet.h"
+
+namespace {
+
+struct BenchOptions {
+    std::size_t lines = 16;
+    std::size_t products = 20000;
+    std::size_t workers = 0;    ///< 0: sweep 1, 2, 4, ...
+    std::size_t producers = 2;
+};
+
+bool parseArgs(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::size_t value = static_cast<std::size_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        if (std::strcmp(argv[i], "--lines") == 0) options.lines = value;
+        else if (std::strcmp(argv[i], "--products") == 0) options.products = value;
+        else if (std::strcmp(argv[i], "--workers") == 0) options.workers = value;
+        else if (std::strcmp(argv[i], "--producers") == 0) options.producers = value;
+        else return false;
+    }
+    return argc % 2 == 1 && options.lines > 0 && options.producers > 0;
+}
+
+FleetStats runOnce(const BenchOptions& bench, std::size_t workers, double& worstP99Us) {
+    FleetOptions options;
+    options.lineCount = bench.lines;
+    options.workerThreads = workers;
+    options.queueCapacity = 4096;
+    options.machine.consoleSeverity = EventSeverity::OFF;
+    options.machine.log.format = LogFormat::MAPPED_RING;
+    options.machine.log.ringCapacity = 4096;
+
+    FleetController fleet(options);
+    fleet.start();
+
+    // Each producer owns a disjoint set of lines (SPSC contract)
+    std::vector<std::thread> producers;
+    const std::size_t producerCount = std::min(bench.producers, bench.lines);
+    for (std::size_t p = 0; p < producerCount; p++) {
+        producers.emplace_back([&, p]() {
+            for (std::size_t line = p; line < bench.lines; line += producerCount) {
+                while (!fleet.postCommand(line, LineCommandType::LOAD_LABEL_ROLL,
+                                          static_cast<std::int32_t>(bench.products + 1))) {
+                    std::this_thread::yield();
+                }
+            }
+            for (std::size_t n = 0; n < bench.products; n++) {
+                for (std::size_t line = p; line < bench.lines; line += producerCount) {
+                    while (!fleet.postSensorEvent(line, true)) std::this_thread::yield();
+                    while (!fleet.postSensorEvent(line, false)) std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    fleet.stop();
+
+    worstP99Us = 0.0;
+    for (std::size_t line = 0; line < fleet.lineCount(); line++) {
+        worstP99Us = std::max(worstP99Us, fleet.lineStats(line).p99LatencyUs);
+    }
+    return fleet.stats();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions bench;
+    if (!parseArgs(argc, argv, bench)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--lines N] [--products P] [--workers W] [--producers K]\n";
+        return 2;
+    }
+
+    std::vector<std::size_t> sweep;
+    if (bench.workers > 0) {
+        sweep.push_back(bench.workers);
+    } else {
+        const std::size_t hardware = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        for (std::size_t w = 1; w <= std::min(hardware, bench.lines); w *= 2) {
+            sweep.push_back(w);
+        }
+    }
+
+    std::printf("lines=%zu products/line=%zu producers=%zu\n", bench.lines, bench.products, bench.producers);
+    std::printf("%8s %12s %14s %10s %14s\n", "workers", "seconds", "labels/s", "speedup", "worst p99 us");
+    double baseline = 0.0;
+    for (std::size_t workers : sweep) {
+        double worstP99Us = 0.0;
+        FleetStats stats = runOnce(bench, workers, worstP99Us);
+        if (baseline == 0.0) {
+            baseline = stats.labelsPerSecond;
+        }
+        std::printf("%8zu %12.3f %14.0f %10.2f %14.1f\n", stats.workers, stats.elapsedSeconds,
+                    stats.labelsPerSecond, baseline > 0.0 ? stats.labelsPerSecond / baseline : 0.0,
+                    worstP99Us);
+    }
+    return 0;
+}
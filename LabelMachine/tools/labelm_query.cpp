@@ -0,0 +1,86 @@
+/**
+ * @file labelm_query.cpp
+ * @brief Prints the rows of a CSV production log within a time range
+ *
+ * Usage: labelm-query <log> <from> <to>
+ *
+ * from/to are local times `YYYY-MM-DD HH:MM[:SS]`, both inclusive, e.g.
+ *   labelm-query LM3000-003_production_log.txt "2025-10-05 14:00" "2025-10-05 14:05"
+ *
+ * With the sidecar index `<log>.idx` only the part of the log around the
+ * range is read; without it the log is scanned from the start. Matching
+ * rows are written to stdout in the log's CSV layout, a summary of the
+ * work done to stderr.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "labelm_logindex.h"
+
+namespace {
+
+/**
+ * @brief Parses `YYYY-MM-DD HH:MM` or `YYYY-MM-DD HH:MM:SS`
+ * @param endOfRange Round a minute-only time up to its last second
+ */
+bool parseTime(const char* text, bool endOfRange, std::int64_t& timestampNs) {
+    char buffer[20];
+    const std::size_t length = std::strlen(text);
+    if (length == 16) {
+        std::memcpy(buffer, text, 16);
+        std::memcpy(buffer + 16, endOfRange ? ":59" : ":00", 3);
+    } else if (length == 19) {
+        std::memcpy(buffer, text, 19);
+    } else {
+        return false;
+    }
+    TimestampParser parser;
+    return parser.parse(buffer, 19, timestampNs);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <log> <from> <to>   (times: \"YYYY-MM-DD HH:MM[:SS]\")\n";
+        return 2;
+    }
+    std::int64_t fromNs = 0;
+    std::int64_t toNs = 0;
+    if (!parseTime(argv[2], false, fromNs) || !parseTime(argv[3], true, toNs)) {
+        std::cerr << "[ERROR] Times must look like \"YYYY-MM-DD HH:MM\" or \"YYYY-MM-DD HH:MM:SS\"\n";
+        return 2;
+    }
+    // Timestamps have second resolution: include the whole last second
+    toNs += 999999999;
+
+    static char outputBuffer[1 << 16];
+    std::setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+    std::fputs(CSV_LOG_HEADER, stdout);
+
+    LogQueryStats stats;
+    std::string error;
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = queryCsvLog(argv[1], fromNs, toNs,
+        [](const CsvLogRow&, const char* text, std::size_t length) {
+            std::fwrite(text, 1, length, stdout);
+            std::fputc('\n', stdout);
+        }, error, &stats);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::fflush(stdout);
+
+    if (!ok) {
+        std::cerr << "[ERROR] " << error << "\n";
+        return 1;
+    }
+    std::fprintf(stderr, "[INFO] %llu rows in %.3f ms; scanned %llu bytes from offset %llu (%s)\n",
+                 static_cast<unsigned long long>(stats.rowsMatched), ms,
+                 static_cast<unsigned long long>(stats.bytesScanned),
+                 static_cast<unsigned long long>(stats.startOffset),
+                 stats.usedIndex ? "indexed" : "no index, full scan");
+    return 0;
+}
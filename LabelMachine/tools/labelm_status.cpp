@@ -0,0 +1,88 @@
+/**
+ * @file labelm_status.cpp
+ * @brief Prints the live status of a running machine from shared memory
+ *
+ * Usage: labelm-status [machineId] [--watch <ms>] [--count <n>]
+ *
+ * Reads the status block published by a machine constructed with
+ * MachineOptions::statusBlock (see labelm_status.h). Reading never blocks
+ * or slows the machine. With --watch the status is printed every <ms>
+ * milliseconds, one line per snapshot, until --count lines were printed
+ * (default: forever) or the machine goes offline.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "labelm_status.h"
+#include "labelm_time.h"
+#include "labelm_types.h"
+
+namespace {
+
+const char* stateName(std::uint8_t state) {
+    return machineStateName(static_cast<MachineState>(state));
+}
+
+void printSnapshot(const MachineStatusSnapshot& status) {
+    TimestampFormatter formatter;
+    char updated[TimestampFormatter::BUFFER_SIZE];
+    formatter.format(status.updatedNs, updated, sizeof(updated), true);
+    std::printf("%s %s state=%s (from %s) speed=%d labels=%d labeled=%d errors=%d temp=%.1f product=%d config=v%u #%llu\n",
+                updated, status.machineId, stateName(status.state), stateName(status.previousState),
+                status.conveyorSpeed, status.labelRollRemaining, status.productsLabeled, status.errorCount,
+                status.temperature, status.productDetected, status.configVersion,
+                static_cast<unsigned long long>(status.publishCount));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string machineId = "LM3000-001";
+    long watchMs = 0;
+    long count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            watchMs = std::strtol(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = std::strtol(argv[++i], nullptr, 10);
+        } else if (argv[i][0] != '-') {
+            machineId = argv[i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [machineId] [--watch <ms>] [--count <n>]\n";
+            return 2;
+        }
+    }
+
+    const std::string name = statusBlockName(machineId);
+    StatusReader reader(name);
+    if (!reader.isOpen()) {
+        std::cerr << "[ERROR] No status block " << name << " (machine not running or statusBlock disabled)\n";
+        return 1;
+    }
+
+    std::uint64_t lastPublished = 0;
+    for (long printed = 0; count <= 0 || printed < count;) {
+        MachineStatusSnapshot status;
+        if (reader.read(status) && status.publishCount != lastPublished) {
+            printSnapshot(status);
+            std::fflush(stdout);
+            lastPublished = status.publishCount;
+            printed++;
+        }
+        if (watchMs <= 0) {
+            break;
+        }
+        if (!reader.isOnline()) {
+            std::cerr << "[INFO] Machine " << machineId << " went offline\n";
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+    }
+    return 0;
+}